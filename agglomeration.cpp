@@ -0,0 +1,105 @@
+// Krugman dissimilarity between locations and Ellison-Glaeser co-agglomeration
+// between activities, from a locations x activities count matrix.
+//
+//   agglomeration krugman --counts Data/cnae/2023/counts.csr --out Data/prox/location_krugman.tri
+//   agglomeration eg --counts Data/cnae/2023/counts.csr --out Data/prox/activity_eg.tri
+//
+// krugman: K_cd = sum_p |s_cp - s_dp| with s_cp = X_cp / X_c, from 0 (same
+// activity mix) to 2 (disjoint), for every pair of locations with counts; a
+// dissimilarity to set beside the correlation proximity of loc_prox.py.
+// eg: gamma_ij = sum_m (s_mi - x_m)(s_mj - x_m) / (1 - H), the pairwise
+// co-agglomeration index of Ellison, Glaeser & Kerr (2010), with s_mi = X_mi /
+// X_i the share of activity i's employment in location m, x_m = X_m / X the
+// location's share of all employment and H = sum_m x_m^2 their Herfindahl.
+//
+// Both are written as a packed upper triangle (.tri, netio.h) over the
+// locations or activities with non-zero totals.
+
+#include "cli.h"
+#include "netio.h"
+#include "pairwise.h"
+
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace cne;
+
+int main(int argc, char** argv) {
+    try {
+        Args args(argc, argv);
+        if (args.positional().size() != 1) throw std::runtime_error("usage: agglomeration krugman|eg --counts ...");
+        std::string mode = args.positional()[0];
+        Csr counts = load_csr(args.get("counts"));
+        size_t n = counts.rows, P = counts.cols;
+        std::vector<double> row_total(n, 0.0), col_total(P, 0.0);
+        double total = 0;
+        for (size_t c = 0; c < n; ++c)
+            for (uint64_t e = counts.offsets[c]; e < counts.offsets[c + 1]; ++e) {
+                row_total[c] += counts.values[e];
+                col_total[counts.indices[e]] += counts.values[e];
+                total += counts.values[e];
+            }
+        if (!(total > 0)) throw std::runtime_error("count matrix is empty");
+
+        // Rows of the share matrix, one per kept location (krugman) or
+        // activity (eg)
+        std::vector<int64_t> row_id(n, -1), col_id(P, -1);
+        Labels rows_kept, cols_kept;
+        for (size_t c = 0; c < n; ++c)
+            if (row_total[c] > 0) row_id[c] = rows_kept.intern(counts.row_labels[c]);
+        for (size_t p = 0; p < P; ++p)
+            if (col_total[p] > 0) col_id[p] = cols_kept.intern(counts.col_labels[p]);
+
+        Triangle t;
+        if (mode == "krugman") {
+            size_t m = rows_kept.size(), dim = cols_kept.size();
+            std::vector<float> shares(m * dim, 0.0f);
+            for (size_t c = 0; c < n; ++c)
+                for (uint64_t e = counts.offsets[c]; e < counts.offsets[c + 1]; ++e)
+                    if (row_id[c] >= 0 && col_id[counts.indices[e]] >= 0)
+                        shares[row_id[c] * dim + col_id[counts.indices[e]]] += float(counts.values[e] / row_total[c]);
+            std::cout << "Krugman dissimilarity: " << m << " locations x " << dim << " activities" << std::endl;
+            t.n = m;
+            t.labels = rows_kept;
+            t.values = Buffer<double>(pairwise_l1(shares.data(), m, dim));
+        } else if (mode == "eg") {
+            size_t m = cols_kept.size(), dim = rows_kept.size();
+            double herfindahl = 0;
+            std::vector<double> x(dim, 0.0);
+            for (size_t c = 0; c < n; ++c)
+                if (row_id[c] >= 0) {
+                    x[row_id[c]] = row_total[c] / total;
+                    herfindahl += x[row_id[c]] * x[row_id[c]];
+                }
+            if (!(herfindahl < 1)) throw std::runtime_error("eg needs more than one location");
+            // Centred shares s_mi - x_m, scaled by 1 / sqrt(1 - H) so that the
+            // dot products are the indices. Centred in double, then rounded.
+            std::vector<double> s(m * dim, 0.0);
+            for (size_t c = 0; c < n; ++c)
+                for (uint64_t e = counts.offsets[c]; e < counts.offsets[c + 1]; ++e) {
+                    uint32_t p = counts.indices[e];
+                    if (row_id[c] >= 0 && col_id[p] >= 0)
+                        s[col_id[p] * dim + row_id[c]] += counts.values[e] / col_total[p];
+                }
+            double scale = 1 / std::sqrt(1 - herfindahl);
+            std::vector<float> centred(m * dim);
+            for (size_t i = 0; i < m; ++i)
+                for (size_t k = 0; k < dim; ++k) centred[i * dim + k] = float((s[i * dim + k] - x[k]) * scale);
+            std::cout << "Co-agglomeration: " << m << " activities x " << dim << " locations, H = " << herfindahl
+                      << std::endl;
+            t.n = m;
+            t.labels = cols_kept;
+            t.values = Buffer<double>(pairwise_dot(centred.data(), m, dim));
+        } else {
+            throw std::runtime_error("unknown mode " + mode + " (expected krugman or eg)");
+        }
+        save_triangle(args.get("out"), t);
+        std::cout << t.values.size() << " pairs saved to " << args.get("out") << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+// Walker's alias method (Vose's construction): O(n) setup, O(1) draws from a
+// fixed discrete distribution. Tables are flat arrays so that many of them can
+// share one allocation (one per node, or one per arc for node2vec).
+
+#include "rng.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace cne {
+
+// Fills prob[0..n) and alias[0..n) for non-negative weights. All-zero weights
+// give the uniform distribution.
+inline void build_alias(const double* weights, size_t n, float* prob, uint32_t* alias) {
+    double total = 0;
+    for (size_t i = 0; i < n; ++i) total += weights[i];
+    std::vector<double> scaled(n);
+    std::vector<uint32_t> small, large;
+    for (size_t i = 0; i < n; ++i) {
+        scaled[i] = total > 0 ? weights[i] * n / total : 1.0;
+        (scaled[i] < 1 ? small : large).push_back(uint32_t(i));
+    }
+    while (!small.empty() && !large.empty()) {
+        uint32_t s = small.back(), l = large.back();
+        small.pop_back();
+        prob[s] = float(scaled[s]);
+        alias[s] = l;
+        scaled[l] -= 1 - scaled[s];
+        if (scaled[l] < 1) {
+            large.pop_back();
+            small.push_back(l);
+        }
+    }
+    // Leftovers are 1 up to rounding
+    for (uint32_t i : small) prob[i] = 1, alias[i] = i;
+    for (uint32_t i : large) prob[i] = 1, alias[i] = i;
+}
+
+inline uint32_t sample_alias(const float* prob, const uint32_t* alias, size_t n, Rng& rng) {
+    double u = rng.uniform() * n;
+    size_t i = size_t(u);
+    return float(u - i) < prob[i] ? uint32_t(i) : alias[i];
+}
+
+}  // namespace cne
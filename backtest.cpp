@@ -0,0 +1,182 @@
+// Backtest of relatedness: does density in year t predict which activities a
+// location enters by year t+k?
+//
+//   backtest --from Data/cnae/2019/rca.mat --to Data/cnae/2023/rca.mat
+//            --proximity Data/cnae/2019/proximity.mat --out results/backtest_2019_2023
+//            [--threshold 1.0] [--bins 20] [--top 1000 --top 10000] [--save-pairs]
+//
+// --from/--to are RCA matrices (rca --save-rca) and --proximity the year-t
+// product proximity, all aligned on their labels. M = RCA >= threshold. Every
+// pair (c, p) with M_cp = 0 in year t is a candidate, scored by the density
+//   omega_cp = sum_p' M_cp' phi_p'p / sum_p' phi_p'p
+// and positive when M_cp = 1 in year t+k. Locations without any RCA in either
+// year are skipped.
+//
+// Writes <out>_summary.csv (candidates, positives, base rate, ROC-AUC, average
+// precision), <out>_precision.csv (precision, recall and lift at each --top k,
+// by default 100, 1000, 10000 and the number of positives),
+// <out>_calibration.csv (appearance rate per equal-count density bin) and,
+// with --save-pairs, every candidate to <out>_pairs.csv.
+
+#include "cli.h"
+#include "metrics.h"
+#include "netio.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace cne;
+
+namespace {
+
+// Activities with RCA >= threshold per location of `rca`, as ids of
+// `activities`; activities missing from it are ignored
+std::vector<std::vector<uint32_t>> binary_rows(const Matrix& rca, const Labels& activities, double threshold) {
+    std::vector<int64_t> col(rca.cols);
+    for (size_t j = 0; j < rca.cols; ++j) col[j] = activities.find(rca.col_labels[j]);
+    std::vector<std::vector<uint32_t>> rows(rca.rows);
+#pragma omp parallel for schedule(dynamic, 64)
+    for (size_t c = 0; c < rca.rows; ++c) {
+        const double* r = rca.row(c);
+        for (size_t j = 0; j < rca.cols; ++j)
+            if (col[j] >= 0 && r[j] >= threshold) rows[c].push_back(uint32_t(col[j]));
+        std::sort(rows[c].begin(), rows[c].end());
+    }
+    return rows;
+}
+
+bool has_data(const Matrix& rca, size_t c) {
+    const double* r = rca.row(c);
+    return std::any_of(r, r + rca.cols, [](double x) { return x > 0; });
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    try {
+        Args args(argc, argv);
+        Matrix from = load_matrix(args.get("from"));
+        Matrix to = load_matrix(args.get("to"));
+        Matrix phi = load_matrix(args.get("proximity"));
+        if (phi.rows != phi.cols) throw std::runtime_error("proximity must be square");
+        double threshold = args.number("threshold", 1.0);
+        std::string out = args.get("out");
+        const Labels& activities = phi.row_labels;
+        size_t P = phi.rows;
+
+        std::vector<std::vector<uint32_t>> m_from = binary_rows(from, activities, threshold);
+        std::vector<std::vector<uint32_t>> m_to = binary_rows(to, activities, threshold);
+
+        // Activities must exist in both years to be candidates
+        std::vector<char> both(P, 0);
+        for (size_t j = 0; j < from.cols; ++j) {
+            int64_t p = activities.find(from.col_labels[j]);
+            if (p >= 0 && to.col_labels.find(from.col_labels[j]) >= 0) both[p] = 1;
+        }
+        std::vector<std::pair<uint32_t, uint32_t>> locations;  // (row in from, row in to)
+        for (size_t c = 0; c < from.rows; ++c) {
+            int64_t d = to.row_labels.find(from.row_labels[c]);
+            if (d >= 0 && has_data(from, c) && has_data(to, d)) locations.emplace_back(uint32_t(c), uint32_t(d));
+        }
+        std::cout << "Candidates from " << locations.size() << " locations x "
+                  << std::count(both.begin(), both.end(), 1) << " activities" << std::endl;
+
+        std::vector<double> column_sum(P, 0.0);
+        for (size_t q = 0; q < P; ++q)
+            for (size_t p = 0; p < P; ++p) column_sum[p] += phi.at(q, p);
+
+        // Per location: its candidates in activity order, positions fixed by
+        // a prefix sum so the rows can be filled in parallel
+        std::vector<size_t> start(locations.size() + 1, 0);
+        for (size_t i = 0; i < locations.size(); ++i) {
+            size_t held = 0;
+            for (uint32_t p : m_from[locations[i].first]) held += both[p];
+            start[i + 1] = start[i] + std::count(both.begin(), both.end(), 1) - held;
+        }
+        std::vector<Prediction> predictions(start.back());
+        std::vector<uint32_t> pair_activity(args.has("save-pairs") ? start.back() : 0);
+#pragma omp parallel
+        {
+            std::vector<double> sum(P);
+            std::vector<char> held(P, 0), later(P, 0);
+#pragma omp for schedule(dynamic, 16)
+            for (size_t i = 0; i < locations.size(); ++i) {
+                const auto& now = m_from[locations[i].first];
+                const auto& next = m_to[locations[i].second];
+                std::fill(sum.begin(), sum.end(), 0.0);
+                for (uint32_t q : now) {
+                    held[q] = 1;
+                    const double* row = phi.row(q);
+                    for (size_t p = 0; p < P; ++p) sum[p] += row[p];
+                }
+                for (uint32_t p : next) later[p] = 1;
+                size_t k = start[i];
+                for (size_t p = 0; p < P; ++p) {
+                    if (!both[p] || held[p]) continue;
+                    predictions[k] = {column_sum[p] > 0 ? sum[p] / column_sum[p] : 0.0, later[p] != 0};
+                    if (!pair_activity.empty()) pair_activity[k] = uint32_t(p);
+                    ++k;
+                }
+                for (uint32_t q : now) held[q] = 0;
+                for (uint32_t p : next) later[p] = 0;
+            }
+        }
+
+        if (args.has("save-pairs")) {
+            std::ofstream pairs(out + "_pairs.csv");
+            pairs << "location,activity,density,appeared\n";
+            pairs.precision(10);
+            for (size_t i = 0; i < locations.size(); ++i)
+                for (size_t k = start[i]; k < start[i + 1]; ++k)
+                    pairs << from.row_labels[locations[i].first] << ',' << activities[pair_activity[k]] << ','
+                          << predictions[k].score << ',' << int(predictions[k].positive) << '\n';
+            if (!pairs) throw std::runtime_error(out + "_pairs.csv: write failed");
+        }
+
+        sort_by_score(predictions);
+        RankingSummary s = summarise_ranking(predictions);
+        double base_rate = predictions.empty() ? 0.0 : double(s.positives) / predictions.size();
+        std::cout << predictions.size() << " candidate pairs, " << s.positives << " appeared (base rate " << base_rate
+                  << "): ROC-AUC " << s.auc << ", average precision " << s.average_precision << std::endl;
+
+        std::ofstream summary(out + "_summary.csv");
+        summary.precision(10);
+        summary << "metric,value\n"
+                << "candidates," << predictions.size() << '\n'
+                << "positives," << s.positives << '\n'
+                << "base_rate," << base_rate << '\n'
+                << "roc_auc," << s.auc << '\n'
+                << "average_precision," << s.average_precision << '\n';
+
+        std::vector<size_t> ks;
+        for (const auto& k : args.all("top")) ks.push_back(std::stoul(k));
+        if (ks.empty()) ks = {100, 1000, 10000, s.positives};
+        std::vector<double> precision = precision_at(predictions, ks);
+        std::ofstream top(out + "_precision.csv");
+        top.precision(10);
+        top << "k,precision,recall,lift\n";
+        for (size_t i = 0; i < ks.size(); ++i) {
+            size_t k = std::min(ks[i], predictions.size());
+            double recall = s.positives ? precision[i] * k / s.positives : 0.0;
+            top << ks[i] << ',' << precision[i] << ',' << recall << ','
+                << (base_rate > 0 ? precision[i] / base_rate : 0.0) << '\n';
+        }
+
+        std::ofstream bins(out + "_calibration.csv");
+        bins.precision(10);
+        bins << "bin,min_density,max_density,mean_density,appearance_rate,pairs\n";
+        auto curve = calibration(predictions, args.integer("bins", 20));
+        for (size_t b = 0; b < curve.size(); ++b)
+            bins << b << ',' << curve[b].min_score << ',' << curve[b].max_score << ',' << curve[b].mean_score << ','
+                 << curve[b].rate << ',' << curve[b].count << '\n';
+        if (!summary || !top || !bins) throw std::runtime_error(out + ": write failed");
+        std::cout << "Summary, precision and calibration saved to " << out << "_*.csv" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+// Dynamic bit set over 64-bit words, for dense adjacency among the few
+// hundred neighbours of a vertex where intersections dominate the work.
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace cne {
+
+class Bitset {
+public:
+    explicit Bitset(size_t bits = 0) : words_((bits + 63) / 64, 0) {}
+
+    // Resizes to `bits` and clears every bit
+    void reset(size_t bits) { words_.assign((bits + 63) / 64, 0); }
+
+    void set(size_t i) { words_[i >> 6] |= uint64_t(1) << (i & 63); }
+    void clear(size_t i) { words_[i >> 6] &= ~(uint64_t(1) << (i & 63)); }
+    bool test(size_t i) const { return (words_[i >> 6] >> (i & 63)) & 1; }
+
+    size_t count() const {
+        size_t c = 0;
+        for (uint64_t w : words_) c += __builtin_popcountll(w);
+        return c;
+    }
+
+    // |*this & other|, both of the same size
+    size_t count_and(const Bitset& other) const {
+        size_t c = 0;
+        for (size_t k = 0; k < words_.size(); ++k) c += __builtin_popcountll(words_[k] & other.words_[k]);
+        return c;
+    }
+
+    // *this = a & b; all three have the same size
+    void assign_and(const Bitset& a, const Bitset& b) {
+        words_.resize(a.words_.size());
+        for (size_t k = 0; k < words_.size(); ++k) words_[k] = a.words_[k] & b.words_[k];
+    }
+
+    // Calls f(i) for every set bit, ascending
+    template <typename F>
+    void for_each(F f) const {
+        for (size_t k = 0; k < words_.size(); ++k)
+            for (uint64_t w = words_[k]; w; w &= w - 1) f(k * 64 + __builtin_ctzll(w));
+    }
+
+    const std::vector<uint64_t>& words() const { return words_; }
+
+private:
+    std::vector<uint64_t> words_;
+};
+
+}  // namespace cne
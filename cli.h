@@ -0,0 +1,56 @@
+#pragma once
+
+// Minimal "--key value" argument parsing for the C++ tools. Flags given more
+// than once keep every value; positional arguments are collected in order.
+
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace cne {
+
+class Args {
+public:
+    Args(int argc, char** argv) {
+        for (int i = 1; i < argc; ++i) {
+            std::string a = argv[i];
+            if (a.rfind("--", 0) == 0) {
+                std::string key = a.substr(2);
+                std::string value = "1";
+                if (i + 1 < argc && std::string(argv[i + 1]).rfind("--", 0) != 0) value = argv[++i];
+                options_[key].push_back(value);
+            } else {
+                positional_.push_back(a);
+            }
+        }
+    }
+
+    bool has(const std::string& key) const { return options_.count(key) > 0; }
+
+    std::string get(const std::string& key) const {
+        auto it = options_.find(key);
+        if (it == options_.end()) throw std::runtime_error("missing required option --" + key);
+        return it->second.back();
+    }
+    std::string get(const std::string& key, const std::string& fallback) const {
+        return has(key) ? get(key) : fallback;
+    }
+    double number(const std::string& key, double fallback) const {
+        return has(key) ? std::stod(get(key)) : fallback;
+    }
+    long integer(const std::string& key, long fallback) const {
+        return has(key) ? std::stol(get(key)) : fallback;
+    }
+    std::vector<std::string> all(const std::string& key) const {
+        auto it = options_.find(key);
+        return it == options_.end() ? std::vector<std::string>{} : it->second;
+    }
+    const std::vector<std::string>& positional() const { return positional_; }
+
+private:
+    std::map<std::string, std::vector<std::string>> options_;
+    std::vector<std::string> positional_;
+};
+
+}  // namespace cne
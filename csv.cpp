@@ -0,0 +1,55 @@
+#include "csv.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace cne {
+
+std::vector<std::string> split_csv_line(const std::string& line) {
+    std::vector<std::string> fields;
+    std::stringstream in(line);
+    for (std::string field; std::getline(in, field, ',');) fields.push_back(field);
+    if (!line.empty() && line.back() == ',') fields.emplace_back();
+    return fields;
+}
+
+NodeTable read_node_table(const std::string& path, const Labels& labels) {
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error(path + ": cannot open");
+    NodeTable table;
+    std::string line;
+    if (!std::getline(in, line)) throw std::runtime_error(path + ": empty file");
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+    table.header = split_csv_line(line);
+    if (table.header.size() < 2) throw std::runtime_error(path + ": no value columns");
+    table.values.assign(table.header.size() - 1, std::vector<double>(labels.size(), NAN));
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        std::vector<std::string> fields = split_csv_line(line);
+        if (fields.empty()) continue;
+        int64_t v = labels.find(fields[0]);
+        if (v < 0) {
+            ++table.unmatched;
+            continue;
+        }
+        ++table.matched;
+        for (size_t c = 0; c < table.values.size() && c + 1 < fields.size(); ++c) {
+            const char* s = fields[c + 1].c_str();
+            char* end = nullptr;
+            double value = std::strtod(s, &end);
+            if (end != s) table.values[c][v] = value;
+        }
+    }
+    return table;
+}
+
+size_t column_index(const NodeTable& table, const std::string& name) {
+    for (size_t c = 1; c < table.header.size(); ++c)
+        if (table.header[c] == name) return c - 1;
+    throw std::runtime_error("no column " + name);
+}
+
+}  // namespace cne
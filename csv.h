@@ -0,0 +1,28 @@
+#pragma once
+
+// Node attribute tables: CSV files whose first column is the node label and
+// whose other columns are numbers (ice.csv, nodes written by the tools, or
+// any pandas DataFrame saved with its index).
+
+#include "netio.h"
+
+#include <string>
+#include <vector>
+
+namespace cne {
+
+std::vector<std::string> split_csv_line(const std::string& line);
+
+struct NodeTable {
+    std::vector<std::string> header;          // including the label column
+    std::vector<std::vector<double>> values;  // [column][node id]; NaN when missing
+    size_t matched = 0, unmatched = 0;        // CSV rows with / without a node
+};
+
+// Reads every column after the first, aligned to `labels`
+NodeTable read_node_table(const std::string& path, const Labels& labels);
+
+// Index of `name` among the value columns (header minus the label column)
+size_t column_index(const NodeTable& table, const std::string& name);
+
+}  // namespace cne
@@ -0,0 +1,401 @@
+#include "eci.h"
+
+#include "parallel.h"
+#include "roaring.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace cne {
+
+CountWindow::CountWindow(size_t locations, size_t activities)
+    : rows_(locations), location_totals_(locations, 0.0), activity_totals_(activities, 0.0) {}
+
+void CountWindow::add(const Csr& year, const std::vector<uint32_t>& row_map,
+                      const std::vector<uint32_t>& col_map, double sign) {
+    if (row_map.size() != year.rows || col_map.size() != year.cols)
+        throw std::runtime_error("count matrix does not match its label maps");
+
+    // Rows map to distinct window rows, so each merge touches one row only;
+    // activity totals are accumulated per thread.
+    std::vector<std::vector<double>> partial(thread_count(), std::vector<double>(activities(), 0.0));
+    double total = 0;
+#pragma omp parallel for schedule(dynamic, 64) reduction(+ : total)
+    for (uint64_t r = 0; r < year.rows; ++r) {
+        std::vector<Cell> delta;
+        delta.reserve(year.degree(r));
+        for (uint64_t e = year.offsets[r]; e < year.offsets[r + 1]; ++e)
+            if (year.values[e] != 0) delta.emplace_back(col_map[year.indices[e]], sign * year.values[e]);
+        if (delta.empty()) continue;
+        std::sort(delta.begin(), delta.end());
+
+        auto& acc = partial[thread_id()];
+        double row_sum = 0;
+        for (const auto& [p, v] : delta) {
+            acc[p] += v;
+            row_sum += v;
+        }
+        uint32_t c = row_map[r];
+        location_totals_[c] += row_sum;
+        total += row_sum;
+
+        const auto& old = rows_[c];
+        std::vector<Cell> merged;
+        merged.reserve(old.size() + delta.size());
+        size_t i = 0, j = 0;
+        while (i < old.size() || j < delta.size()) {
+            Cell cell;
+            if (j == delta.size() || (i < old.size() && old[i].first < delta[j].first)) {
+                cell = old[i++];
+            } else if (i == old.size() || delta[j].first < old[i].first) {
+                cell = delta[j++];
+            } else {
+                cell = {old[i].first, old[i].second + delta[j].second};
+                ++i, ++j;
+            }
+            if (std::fabs(cell.second) > 1e-9) merged.push_back(cell);
+        }
+        rows_[c] = std::move(merged);
+    }
+    total_ += total;
+    for (const auto& acc : partial)
+        for (size_t p = 0; p < acc.size(); ++p) activity_totals_[p] += acc[p];
+}
+
+namespace {
+
+// Lorenz point of one cell for its activity's Gini: (RCA, X_c / X, X_cp / X_p)
+struct LorenzPoint {
+    uint32_t p;
+    double rca, x, y;
+};
+
+ConcentrationIndices empty_indices(size_t n, size_t P) {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    ConcentrationIndices r;
+    r.entropy.assign(n, nan);
+    r.hhi.assign(n, nan);
+    r.theil.assign(n, nan);
+    r.krugman.assign(n, nan);
+    r.gini.assign(P, nan);
+    return r;
+}
+
+// Location indices of row c from the cells of the row, given with their RCA;
+// the cells' Lorenz points go to `points`
+class RowIndices {
+public:
+    RowIndices(const CountWindow& window, size_t c) : window_(window), c_(c), xc_(window.location_total(c)) {}
+
+    bool active() const { return xc_ > 0 && window_.total() > 0; }
+
+    void add(const Cell& cell, double rca, std::vector<LorenzPoint>& points) {
+        double xp = window_.activity_total(cell.first);
+        if (!(cell.second > 0) || !(xp > 0)) return;
+        double s = cell.second / xc_, S = xp / window_.total();
+        entropy_ -= s * std::log(s);
+        hhi_ += s * s;
+        theil_ += s * std::log(s / S);
+        krugman_ += std::fabs(s - S) - S;
+        points.push_back({cell.first, rca, xc_ / window_.total(), cell.second / xp});
+    }
+
+    void store(ConcentrationIndices& r) const {
+        r.entropy[c_] = entropy_;
+        r.hhi[c_] = hhi_;
+        r.theil[c_] = theil_;
+        r.krugman[c_] = krugman_;
+    }
+
+private:
+    const CountWindow& window_;
+    size_t c_;
+    double xc_;
+    double entropy_ = 0, hhi_ = 0, theil_ = 0, krugman_ = 1;  // cells at zero add S_p each
+};
+
+// Groups the per-thread points by activity (counting sort), then one Lorenz
+// curve each
+void lorenz_gini(std::vector<std::vector<LorenzPoint>>& points, ConcentrationIndices& r) {
+    size_t P = r.gini.size();
+    std::vector<size_t> start(P + 1, 0);
+    for (const auto& local : points)
+        for (const auto& pt : local) ++start[pt.p + 1];
+    for (size_t p = 0; p < P; ++p) start[p + 1] += start[p];
+    std::vector<LorenzPoint> columns(start[P]);
+    std::vector<size_t> fill(start.begin(), start.end() - 1);
+    for (auto& local : points) {
+        for (const auto& pt : local) columns[fill[pt.p]++] = pt;
+        std::vector<LorenzPoint>().swap(local);
+    }
+#pragma omp parallel for schedule(dynamic, 16)
+    for (size_t p = 0; p < P; ++p) {
+        if (start[p] == start[p + 1]) continue;
+        LorenzPoint* begin = columns.data() + start[p];
+        LorenzPoint* end = columns.data() + start[p + 1];
+        std::sort(begin, end, [](const LorenzPoint& a, const LorenzPoint& b) { return a.rca < b.rca; });
+        // Locations without the activity come first, along y = 0
+        double y = 0, area = 0;
+        for (const LorenzPoint* q = begin; q != end; ++q) {
+            area += q->x * (2 * y + q->y);
+            y += q->y;
+        }
+        r.gini[p] = 1 - area;
+    }
+}
+
+}  // namespace
+
+ConcentrationIndices concentration_indices(const CountWindow& window) {
+    size_t n = window.locations();
+    ConcentrationIndices r = empty_indices(n, window.activities());
+    if (!(window.total() > 0)) return r;
+    std::vector<std::vector<LorenzPoint>> points(thread_count());
+#pragma omp parallel for schedule(dynamic, 64)
+    for (size_t c = 0; c < n; ++c) {
+        RowIndices row(window, c);
+        if (!row.active()) continue;
+        for (const auto& cell : window.row(c)) row.add(cell, window.rca(c, cell), points[thread_id()]);
+        row.store(r);
+    }
+    lorenz_gini(points, r);
+    return r;
+}
+
+Complexity::Complexity(size_t locations, size_t activities, std::vector<double> thresholds)
+    : thresholds_(std::move(thresholds)), m_(locations) {
+    if (thresholds_.empty() || thresholds_.size() > max_planes)
+        throw std::runtime_error("between 1 and 8 thresholds are supported");
+    diversity_.assign(planes(), std::vector<uint32_t>(locations, 0));
+    ubiquity_.assign(planes(), std::vector<uint32_t>(activities, 0));
+    cooccurrence_.assign(planes(), std::vector<int32_t>(activities * activities, 0));
+    eigenvector_.resize(planes());
+}
+
+size_t Complexity::update(const CountWindow& window, ConcentrationIndices* indices) {
+    size_t n = locations(), P = activities();
+    std::vector<std::vector<SlicedCell>> next(n);
+    std::vector<char> changed(n, 0);
+    // The concentration indices ride on the same traversal and RCA values
+    if (indices) *indices = empty_indices(n, P);
+    bool with_indices = indices && window.total() > 0;
+    std::vector<std::vector<LorenzPoint>> points(with_indices ? thread_count() : 0);
+#pragma omp parallel for schedule(dynamic, 64)
+    for (size_t c = 0; c < n; ++c) {
+        RowIndices row(window, c);
+        bool index_row = with_indices && row.active();
+        for (const auto& cell : window.row(c)) {
+            double rca = window.rca(c, cell);
+            uint8_t bits = 0;
+            for (size_t t = 0; t < planes(); ++t) bits |= uint8_t(rca >= thresholds_[t]) << t;
+            if (bits) next[c].emplace_back(cell.first, bits);
+            if (index_row) row.add(cell, rca, points[thread_id()]);
+        }
+        if (index_row) row.store(*indices);
+        changed[c] = next[c] != m_[c];
+    }
+    if (with_indices) lorenz_gini(points, *indices);
+
+    size_t n_changed = std::count(changed.begin(), changed.end(), 1);
+    auto commit_rows = [&] {
+        for (size_t c = 0; c < n; ++c) {
+            if (!changed[c]) continue;
+            m_[c] = std::move(next[c]);
+            for (size_t t = 0; t < planes(); ++t) diversity_[t][c] = 0;
+            for (const auto& cell : m_[c])
+                for (unsigned b = cell.second; b; b &= b - 1) ++diversity_[__builtin_ctz(b)][c];
+        }
+    };
+    // When most rows changed (e.g. the first window) the deltas would cost
+    // more than recounting every column pair
+    if (2 * n_changed > n) {
+        commit_rows();
+        rebuild();
+        return n_changed;
+    }
+
+    // Co-occurrence moves by outer(new row) - outer(old row) for changed
+    // locations only; bucketing by activity lets each thread own rows of C.
+    // The planes shared by two cells are their bitwise and.
+    std::vector<std::vector<SlicedCell>> gained(P), lost(P);  // (location, planes)
+    for (size_t c = 0; c < n; ++c) {
+        if (!changed[c]) continue;
+        for (const auto& [p, bits] : m_[c]) {
+            lost[p].emplace_back(c, bits);
+            for (unsigned b = bits; b; b &= b - 1) --ubiquity_[__builtin_ctz(b)][p];
+        }
+        for (const auto& [p, bits] : next[c]) {
+            gained[p].emplace_back(c, bits);
+            for (unsigned b = bits; b; b &= b - 1) ++ubiquity_[__builtin_ctz(b)][p];
+        }
+    }
+#pragma omp parallel for schedule(dynamic, 8)
+    for (size_t p = 0; p < P; ++p) {
+        for (const auto& [c, bits] : lost[p])
+            for (const auto& [q, other] : m_[c])
+                for (unsigned b = bits & other; b; b &= b - 1) --cooccurrence_[__builtin_ctz(b)][p * P + q];
+        for (const auto& [c, bits] : gained[p])
+            for (const auto& [q, other] : next[c])
+                for (unsigned b = bits & other; b; b &= b - 1) ++cooccurrence_[__builtin_ctz(b)][p * P + q];
+    }
+    commit_rows();
+    return n_changed;
+}
+
+void Complexity::rebuild() {
+    size_t n = locations(), P = activities(), T = planes();
+    // One scan of M fills the columns of every plane, column t * P + p
+    std::vector<std::vector<uint32_t>> columns(T * P);
+    for (size_t c = 0; c < n; ++c)
+        for (const auto& [p, bits] : m_[c])
+            for (unsigned b = bits; b; b &= b - 1) columns[__builtin_ctz(b) * P + p].push_back(uint32_t(c));
+
+    // A column is kept dense once walking its members would cost more than
+    // popcounting the n / 64 words of a bitset; decided per plane and column
+    std::vector<char> dense(T * P);
+    std::vector<Bitset> bits(T * P);
+    std::vector<Roaring> sparse(T * P);
+#pragma omp parallel for schedule(dynamic, 16)
+    for (size_t k = 0; k < T * P; ++k) {
+        ubiquity_[k / P][k % P] = uint32_t(columns[k].size());
+        dense[k] = columns[k].size() * 64 >= n;
+        if (dense[k]) {
+            bits[k].reset(n);
+            for (uint32_t c : columns[k]) bits[k].set(c);
+        } else {
+            sparse[k] = Roaring::from_sorted(columns[k].data(), columns[k].size());
+        }
+    }
+    auto intersect = [&](size_t a, size_t b) -> size_t {
+        if (dense[a] && dense[b]) return bits[a].count_and(bits[b]);
+        if (dense[a]) return intersection_count(sparse[b], bits[a]);
+        if (dense[b]) return intersection_count(sparse[a], bits[b]);
+        return intersection_count(sparse[a], sparse[b]);
+    };
+
+    // One pass over column pairs updates every plane
+#pragma omp parallel for schedule(dynamic, 4)
+    for (size_t p = 0; p < P; ++p) {
+        for (size_t t = 0; t < T; ++t) cooccurrence_[t][p * P + p] = int32_t(columns[t * P + p].size());
+        for (size_t q = p + 1; q < P; ++q)
+            for (size_t t = 0; t < T; ++t) {
+                int32_t count = columns[t * P + p].empty() || columns[t * P + q].empty()
+                                    ? 0
+                                    : int32_t(intersect(t * P + p, t * P + q));
+                cooccurrence_[t][p * P + q] = cooccurrence_[t][q * P + p] = count;
+            }
+    }
+}
+
+std::vector<double> Complexity::proximity(size_t plane) const {
+    size_t P = activities();
+    const auto& ubiquity = ubiquity_[plane];
+    const auto& cooccurrence = cooccurrence_[plane];
+    std::vector<double> phi(P * P, 0.0);
+#pragma omp parallel for schedule(static)
+    for (size_t p = 0; p < P; ++p)
+        for (size_t q = 0; q < P; ++q) {
+            uint32_t k = std::max(ubiquity[p], ubiquity[q]);
+            if (p != q && k > 0) phi[p * P + q] = double(cooccurrence[p * P + q]) / k;
+        }
+    return phi;
+}
+
+std::vector<double> Complexity::ice(size_t plane, int max_iterations, double tolerance) {
+    size_t n = locations(), P = activities();
+    const auto& diversity = diversity_[plane];
+    const auto& ubiquity = ubiquity_[plane];
+    uint8_t bit = uint8_t(1) << plane;
+
+    // Power iteration on the symmetric S = D_c^-1/2 M D_p^-1 M^T D_c^-1/2,
+    // which shares its spectrum with M~; the top eigenvector sqrt(k_c) is
+    // projected out so the iteration converges to the second one.
+    std::vector<double> inv_sqrt_kc(n, 0.0), top(n, 0.0);
+    double top_norm = 0;
+    for (size_t c = 0; c < n; ++c) {
+        if (diversity[c] == 0) continue;
+        inv_sqrt_kc[c] = 1.0 / std::sqrt(double(diversity[c]));
+        top[c] = std::sqrt(double(diversity[c]));
+        top_norm += diversity[c];
+    }
+    if (top_norm == 0) return std::vector<double>(n, std::numeric_limits<double>::quiet_NaN());
+    for (auto& v : top) v /= std::sqrt(top_norm);
+
+    std::vector<std::vector<uint32_t>> columns(P), rows(n);
+    for (size_t c = 0; c < n; ++c)
+        for (const auto& [p, bits] : m_[c])
+            if (bits & bit) {
+                columns[p].push_back(c);
+                rows[c].push_back(p);
+            }
+
+    auto deflate_normalize = [&](std::vector<double>& y) {
+        double dot = 0, norm = 0;
+        for (size_t c = 0; c < n; ++c) dot += y[c] * top[c];
+        for (size_t c = 0; c < n; ++c) {
+            y[c] = diversity[c] ? y[c] - dot * top[c] : 0.0;
+            norm += y[c] * y[c];
+        }
+        norm = std::sqrt(norm);
+        if (norm > 0)
+            for (auto& v : y) v /= norm;
+        return norm;
+    };
+
+    std::vector<double>& y = eigenvector_[plane];
+    if (y.size() != n || deflate_normalize(y) == 0) {
+        // Deterministic start that is not orthogonal to typical eigenvectors
+        y.assign(n, 0.0);
+        for (size_t c = 0; c < n; ++c) y[c] = diversity[c] * (1.0 + 1e-3 * (c % 7));
+        deflate_normalize(y);
+    }
+
+    std::vector<double> t(P), next(n);
+    for (int it = 0; it < max_iterations; ++it) {
+#pragma omp parallel for schedule(dynamic, 16)
+        for (size_t p = 0; p < P; ++p) {
+            double s = 0;
+            for (uint32_t c : columns[p]) s += y[c] * inv_sqrt_kc[c];
+            t[p] = ubiquity[p] ? s / ubiquity[p] : 0.0;
+        }
+#pragma omp parallel for schedule(dynamic, 64)
+        for (size_t c = 0; c < n; ++c) {
+            double s = 0;
+            for (uint32_t p : rows[c]) s += t[p];
+            next[c] = s * inv_sqrt_kc[c];
+        }
+        if (deflate_normalize(next) == 0) break;
+        double diff = 0;
+        for (size_t c = 0; c < n; ++c) diff += (next[c] - y[c]) * (next[c] - y[c]);
+        y.swap(next);
+        if (diff < tolerance * tolerance) break;
+    }
+
+    // Back to an eigenvector of M~, then standardise as index/ice.py does
+    std::vector<double> k2(n, std::numeric_limits<double>::quiet_NaN());
+    double mean = 0, count = 0;
+    for (size_t c = 0; c < n; ++c)
+        if (diversity[c]) {
+            k2[c] = y[c] * inv_sqrt_kc[c];
+            mean += k2[c];
+            ++count;
+        }
+    mean /= count;
+    double var = 0, cov = 0, mean_k = 0;
+    for (size_t c = 0; c < n; ++c)
+        if (diversity[c]) mean_k += diversity[c] / count;
+    for (size_t c = 0; c < n; ++c)
+        if (diversity[c]) {
+            var += (k2[c] - mean) * (k2[c] - mean);
+            cov += (k2[c] - mean) * (diversity[c] - mean_k);
+        }
+    double sd = std::sqrt(var / count);
+    double sign = cov < 0 ? -1.0 : 1.0;
+    for (size_t c = 0; c < n; ++c)
+        if (diversity[c]) k2[c] = sd > 0 ? sign * (k2[c] - mean) / sd : 0.0;
+    return k2;
+}
+
+}  // namespace cne
@@ -0,0 +1,116 @@
+#pragma once
+
+// Economic complexity quantities on location x activity counts, following the
+// Python pipeline: RCA as in mpe.py/brutos.py, M = RCA >= threshold as in
+// bin.py, product proximity as in prod_prox.py and ICE as in index/ice.py.
+// Counts are kept as a sliding sum of yearly matrices so that a window can
+// advance by one year without re-aggregating, and M, co-occurrence and the
+// ICE eigenvector are updated from the rows that actually changed.
+
+#include "netio.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace cne {
+
+using Cell = std::pair<uint32_t, double>;  // (activity id, count)
+
+// Sum of yearly count matrices with X, X_c and X_p kept current.
+class CountWindow {
+public:
+    CountWindow(size_t locations, size_t activities);
+
+    // Adds sign * year. row_map/col_map translate the year's ids to window ids.
+    void add(const Csr& year, const std::vector<uint32_t>& row_map,
+             const std::vector<uint32_t>& col_map, double sign);
+
+    size_t locations() const { return rows_.size(); }
+    size_t activities() const { return activity_totals_.size(); }
+    const std::vector<Cell>& row(size_t c) const { return rows_[c]; }
+    double total() const { return total_; }
+    double location_total(size_t c) const { return location_totals_[c]; }
+    double activity_total(size_t p) const { return activity_totals_[p]; }
+
+    double rca(size_t c, const Cell& cell) const {
+        double denom = location_totals_[c] * activity_totals_[cell.first];
+        return denom > 0 ? cell.second * total_ / denom : 0.0;
+    }
+
+private:
+    std::vector<std::vector<Cell>> rows_;  // sorted by activity, no zero cells
+    std::vector<double> location_totals_, activity_totals_;
+    double total_ = 0;
+};
+
+// Diversification and concentration of the counts, all from one traversal of
+// the window. Per location c, with shares s_p = X_cp / X_c and the overall
+// structure S_p = X_p / X:
+//   entropy  -sum_p s_p ln s_p
+//   hhi      sum_p s_p^2 (Herfindahl-Hirschman)
+//   theil    sum_p s_p ln(s_p / S_p), divergence from the overall structure
+//   krugman  sum_p |s_p - S_p| (Krugman specialisation index)
+// and per activity the locational Gini: the Gini of the Lorenz curve of its
+// location shares X_cp / X_p against total shares X_c / X, locations sorted
+// by RCA. Locations or activities without counts get NaN. Complexity::update
+// computes them along with M; this standalone form traverses the window once.
+struct ConcentrationIndices {
+    std::vector<double> entropy, hhi, theil, krugman;  // per location
+    std::vector<double> gini;                          // per activity
+};
+
+ConcentrationIndices concentration_indices(const CountWindow& window);
+
+// Binary specialisation matrices for one or more thresholds, bit-sliced: bit
+// t of a cell is set when RCA >= thresholds[t], so every threshold is one
+// bitplane of the same sparse matrix. Diversity, ubiquity and co-occurrence
+// are kept per plane and maintained incrementally across successive windows;
+// each pass over the changed rows updates every plane at once. When most rows
+// change, co-occurrence is recounted from column intersections instead.
+using SlicedCell = std::pair<uint32_t, uint8_t>;  // (activity id, planes)
+
+class Complexity {
+public:
+    static constexpr size_t max_planes = 8;
+
+    Complexity(size_t locations, size_t activities, std::vector<double> thresholds = {1.0});
+
+    // Recomputes the planes of M and applies the changed rows to ubiquity and
+    // co-occurrence. Returns the number of locations whose row changed in any
+    // plane. With `indices`, the concentration indices of the window are
+    // accumulated in the same traversal of its cells.
+    size_t update(const CountWindow& window, ConcentrationIndices* indices = nullptr);
+
+    // phi_pp' = C_pp' / max(k_p, k_p'), zero diagonal (prod_prox.py)
+    std::vector<double> proximity(size_t plane = 0) const;
+
+    // Standardised second eigenvector of M~ = D_c^-1 M D_p^-1 M^T, signed to
+    // correlate positively with diversity. Warm-started from the previous call
+    // on the same plane. Locations with zero diversity get NaN.
+    std::vector<double> ice(size_t plane = 0, int max_iterations = 2000, double tolerance = 1e-10);
+
+    size_t planes() const { return thresholds_.size(); }
+    double threshold(size_t plane) const { return thresholds_[plane]; }
+    const std::vector<SlicedCell>& row(size_t c) const { return m_[c]; }
+    const std::vector<uint32_t>& diversity(size_t plane = 0) const { return diversity_[plane]; }
+    const std::vector<uint32_t>& ubiquity(size_t plane = 0) const { return ubiquity_[plane]; }
+    const std::vector<int32_t>& cooccurrence(size_t plane = 0) const { return cooccurrence_[plane]; }
+    size_t locations() const { return m_.size(); }
+    size_t activities() const { return ubiquity_[0].size(); }
+
+private:
+    // Recounts ubiquity and co-occurrence of every plane from the columns of
+    // M, each stored as a dense Bitset or a Roaring set by its density: one
+    // scan of M and one pass over column pairs for all planes together
+    void rebuild();
+
+    std::vector<double> thresholds_;
+    std::vector<std::vector<SlicedCell>> m_;        // cells in at least one plane, sorted
+    std::vector<std::vector<uint32_t>> diversity_;  // [plane][location]
+    std::vector<std::vector<uint32_t>> ubiquity_;   // [plane][activity]
+    std::vector<std::vector<int32_t>> cooccurrence_;  // [plane] activities x activities, M^T M
+    std::vector<std::vector<double>> eigenvector_;    // [plane] warm start for ice()
+};
+
+}  // namespace cne
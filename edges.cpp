@@ -0,0 +1,64 @@
+#include "edges.h"
+
+#include <algorithm>
+
+namespace cne {
+
+EdgeList edge_list(const Csr& g, const std::vector<uint32_t>& remap) {
+    std::vector<std::pair<uint64_t, double>> edges;
+    edges.reserve(g.nnz() / 2);
+    for (uint64_t u = 0; u < g.rows; ++u)
+        for (uint64_t e = g.offsets[u]; e < g.offsets[u + 1]; ++e)
+            if (u < g.indices[e]) edges.emplace_back(edge_key(remap[u], remap[g.indices[e]]), g.values[e]);
+    std::sort(edges.begin(), edges.end());
+
+    EdgeList out;
+    out.keys.reserve(edges.size());
+    out.weights.reserve(edges.size());
+    for (const auto& [key, w] : edges) {
+        if (!out.keys.empty() && out.keys.back() == key) continue;
+        out.keys.push_back(key);
+        out.weights.push_back(w);
+    }
+    return out;
+}
+
+Csr csr_from_edges(const Labels& labels, const EdgeList& edges, const std::vector<double>* diagonal) {
+    size_t n = labels.size();
+    std::vector<uint64_t> offsets(n + 1, 0);
+    for (uint64_t key : edges.keys) {
+        ++offsets[edge_first(key) + 1];
+        ++offsets[edge_second(key) + 1];
+    }
+    if (diagonal)
+        for (size_t u = 0; u < n; ++u) ++offsets[u + 1];
+    for (size_t u = 0; u < n; ++u) offsets[u + 1] += offsets[u];
+
+    std::vector<uint32_t> indices(offsets[n]);
+    std::vector<double> values(offsets[n]);
+    std::vector<std::vector<std::pair<uint32_t, double>>> rows(n);
+    for (size_t e = 0; e < edges.keys.size(); ++e) {
+        uint32_t u = edge_first(edges.keys[e]), v = edge_second(edges.keys[e]);
+        rows[u].emplace_back(v, edges.weights[e]);
+        rows[v].emplace_back(u, edges.weights[e]);
+    }
+    for (size_t u = 0; u < n; ++u) {
+        if (diagonal) rows[u].emplace_back(u, (*diagonal)[u]);
+        std::sort(rows[u].begin(), rows[u].end());
+        uint64_t pos = offsets[u];
+        for (const auto& [v, w] : rows[u]) {
+            indices[pos] = v;
+            values[pos++] = w;
+        }
+    }
+
+    Csr g;
+    g.rows = g.cols = n;
+    g.row_labels = g.col_labels = labels;
+    g.offsets = Buffer<uint64_t>(std::move(offsets));
+    g.indices = Buffer<uint32_t>(std::move(indices));
+    g.values = Buffer<double>(std::move(values));
+    return g;
+}
+
+}  // namespace cne
@@ -0,0 +1,31 @@
+#pragma once
+
+// Undirected edges as sorted 64-bit keys (smaller id in the high half), for
+// set operations between graphs by sorted merge.
+
+#include "netio.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace cne {
+
+inline uint64_t edge_key(uint32_t u, uint32_t v) {
+    return u < v ? (uint64_t(u) << 32 | v) : (uint64_t(v) << 32 | u);
+}
+inline uint32_t edge_first(uint64_t key) { return uint32_t(key >> 32); }
+inline uint32_t edge_second(uint64_t key) { return uint32_t(key); }
+
+struct EdgeList {
+    std::vector<uint64_t> keys;  // sorted, unique
+    std::vector<double> weights;
+};
+
+// Edges of a symmetric CSR graph with node ids translated through `remap`.
+EdgeList edge_list(const Csr& g, const std::vector<uint32_t>& remap);
+
+// Symmetric CSR graph over `labels` holding both directions of every edge,
+// plus the diagonal when one is given.
+Csr csr_from_edges(const Labels& labels, const EdgeList& edges, const std::vector<double>* diagonal = nullptr);
+
+}  // namespace cne
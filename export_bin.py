@@ -0,0 +1,150 @@
+import argparse
+import struct
+
+import numpy as np
+import pandas as pd
+
+# Binary layouts read by the C++ tools (see netio.h)
+MATRIX_MAGIC = b"CNEMAT1\0"
+CSR_MAGIC = b"CNECSR1\0"
+TRIANGLE_MAGIC = b"CNETRI1\0"
+
+
+def _write_header(f, magic, rows, cols, nnz, row_labels, col_labels):
+    block = "".join(f"{label}\n" for label in row_labels) + "".join(f"{label}\n" for label in col_labels)
+    block = block.encode("utf-8")
+    f.write(magic)
+    f.write(struct.pack("<5Q", rows, cols, nnz, len(block), 0))
+    f.write(block + b"\0" * (-len(block) % 8))
+
+
+def write_matrix(df, path):
+    """
+    Save a DataFrame (labels as index and columns) as a dense .mat file
+    """
+    values = np.ascontiguousarray(df.values, dtype="<f8")
+    with open(path, "wb") as f:
+        _write_header(f, MATRIX_MAGIC, values.shape[0], values.shape[1], 0, df.index, df.columns)
+        f.write(values.tobytes())
+    print(f"Matrix saved to {path} with shape {values.shape}")
+
+
+def write_triangle(df, path):
+    """
+    Save a symmetric DataFrame (e.g. a proximity matrix) as a .tri file holding
+    only its strict upper triangle
+    """
+    values = df.values.astype("<f8")
+    n = values.shape[0]
+    upper = values[np.triu_indices(n, k=1)]
+    with open(path, "wb") as f:
+        _write_header(f, TRIANGLE_MAGIC, n, n, len(upper), df.index, df.index)
+        f.write(np.ascontiguousarray(upper).tobytes())
+    print(f"Upper triangle saved to {path}: {n} nodes, {len(upper)} entries")
+
+
+def write_csr(path, row_labels, col_labels, rows, cols, values):
+    """
+    Save (row, col, value) triplets as a .csr file. Duplicates are summed.
+    """
+    n_rows, n_cols = len(row_labels), len(col_labels)
+    rows = np.asarray(rows, dtype=np.int64)
+    cols = np.asarray(cols, dtype=np.int64)
+    values = np.asarray(values, dtype=np.float64)
+
+    # Sort by (row, col) and merge duplicate entries
+    order = np.lexsort((cols, rows))
+    rows, cols, values = rows[order], cols[order], values[order]
+    if len(rows):
+        keep = np.ones(len(rows), dtype=bool)
+        keep[1:] = (rows[1:] != rows[:-1]) | (cols[1:] != cols[:-1])
+        groups = np.cumsum(keep) - 1
+        values = np.bincount(groups, weights=values)
+        rows, cols = rows[keep], cols[keep]
+
+    offsets = np.zeros(n_rows + 1, dtype="<u8")
+    np.cumsum(np.bincount(rows, minlength=n_rows), out=offsets[1:])
+    indices = cols.astype("<u4")
+    with open(path, "wb") as f:
+        _write_header(f, CSR_MAGIC, n_rows, n_cols, len(indices), row_labels, col_labels)
+        f.write(offsets.tobytes())
+        f.write(indices.tobytes())
+        f.write(b"\0" * (-indices.nbytes % 8))
+        f.write(values.astype("<f8").tobytes())
+    print(f"Sparse matrix saved to {path}: {n_rows} x {n_cols}, {len(indices)} entries")
+
+
+def write_graph(edges, path):
+    """
+    Save an undirected weighted edge list (source, target, weight columns)
+    as a symmetric .csr graph
+    """
+    labels = pd.Index(pd.unique(pd.concat([edges["source"], edges["target"]]).astype(str)))
+    u = labels.get_indexer(edges["source"].astype(str))
+    v = labels.get_indexer(edges["target"].astype(str))
+    w = edges["weight"].to_numpy(dtype=float) if "weight" in edges else np.ones(len(edges))
+    loops = u == v
+    u, v, w = u[~loops], v[~loops], w[~loops]
+    write_csr(path, labels, labels, np.concatenate([u, v]), np.concatenate([v, u]), np.concatenate([w, w]))
+
+
+def write_counts(df, path, rows, cols, values):
+    """
+    Save a long RAIS table as a sparse locations x activities count matrix,
+    summing `values` the same way the pivot_table calls in mpe.py do
+    """
+    df = df[[rows, cols, values]].dropna()
+    row_labels = pd.Index(pd.unique(df[rows].astype(str)))
+    col_labels = pd.Index(pd.unique(df[cols].astype(str)))
+    write_csr(path, row_labels, col_labels,
+              row_labels.get_indexer(df[rows].astype(str)),
+              col_labels.get_indexer(df[cols].astype(str)),
+              df[values].to_numpy(dtype=float))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Export CSV/GraphML outputs to the binary files used by the C++ tools")
+    sub = parser.add_subparsers(dest="kind", required=True)
+
+    p = sub.add_parser("matrix", help="labelled CSV matrix (index in first column) -> .mat")
+    p.add_argument("input")
+    p.add_argument("output")
+
+    p = sub.add_parser("tri", help="symmetric labelled CSV matrix -> packed upper triangle .tri")
+    p.add_argument("input")
+    p.add_argument("output")
+
+    p = sub.add_parser("graph", help="GraphML or edge list CSV (source,target,weight) -> .csr")
+    p.add_argument("input")
+    p.add_argument("output")
+
+    p = sub.add_parser("counts", help="long RAIS CSV -> sparse locations x activities .csr")
+    p.add_argument("input")
+    p.add_argument("output")
+    p.add_argument("--rows", default="Municipality ID")
+    p.add_argument("--cols", default="Class ID")
+    p.add_argument("--values", default="Workers")
+
+    args = parser.parse_args()
+    if args.kind == "matrix":
+        write_matrix(pd.read_csv(args.input, index_col=0), args.output)
+    elif args.kind == "tri":
+        write_triangle(pd.read_csv(args.input, index_col=0), args.output)
+    elif args.kind == "graph":
+        if args.input.endswith(".graphml"):
+            import networkx as nx
+            G = nx.read_graphml(args.input)
+            edges = nx.to_pandas_edgelist(G)
+            if "weight" not in edges:
+                edges["weight"] = 1.0
+            edges = edges[["source", "target", "weight"]]
+        else:
+            edges = pd.read_csv(args.input)
+        write_graph(edges, args.output)
+    elif args.kind == "counts":
+        df = pd.read_csv(args.input, usecols=[args.rows, args.cols, args.values])
+        write_counts(df, args.output, args.rows, args.cols, args.values)
+
+
+if __name__ == "__main__":
+    main()
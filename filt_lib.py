@@ -11,6 +11,8 @@ corr = proximity_matrix  # Use the DataFrame directly
 
 # Calculate covariance matrix if needed
 cov = np.cov(proximity_matrix.values, rowvar=False)  # if needed
+# Keep it for the C++ LoGo stage (export_bin.py matrix, then filter --cov)
+pd.DataFrame(cov, index=proximity_matrix.index, columns=proximity_matrix.columns).to_csv("2023_loc_cov.csv")
 
 # Use the optimized implementation
 model = TMFG()
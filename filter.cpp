@@ -0,0 +1,152 @@
+// Filters a dense similarity matrix into a TMFG, like filt_lib.py, or into a
+// maximally filtered clique forest.
+//
+//   filter --weights Data/prox/location_proximity_matrix.mat --out results/2023_loc_tmfg
+//          [--cov Data/prox/location_covariance.mat]
+//   filter --weights Data/prox/location_proximity_matrix.mat --out results/2023_loc_tmfg
+//          --seeds 16 [--seed-pool 8]
+//   filter --weights Data/prox/product_proximity_matrix.mat --out results/2023_prod_mfcf
+//          --method mfcf --max-clique 6 --threshold 0.2
+//   filter --candidates loc_2023_knn.csr --rca Data/cnae/2023/normalized_2023.mat
+//          --out results/2023_loc_tmfg
+//
+// Writes <out>.csr (edges weighted by the input matrix) and
+// <out>_cliques.txt / <out>_separators.txt, one clique or separator per line
+// as space-separated node labels. With --cov, also writes the LoGo sparse
+// precision matrix <out>_logo.csr and the partial correlations <out>_partial.csr;
+// the covariance is matched to the filtered nodes by label and must cover them.
+// With --seeds, runs that many TMFGs concurrently (seed 0 is the canonical
+// one, the others vary the initial clique and tie-breaks), keeps the one with
+// the largest total weight and lists every run in <out>_seeds.csv.
+// With --candidates (e.g. from `rca_ann knn`), builds the TMFG from that sparse
+// graph instead of a dense matrix; weights it lacks are log-RCA correlations
+// computed on demand from --rca rows, or read from --weights if given.
+
+#include "cli.h"
+#include "filtering.h"
+#include "profiles.h"
+
+#include <fstream>
+#include <iostream>
+#include <string>
+
+using namespace cne;
+
+namespace {
+
+void write_sets(const std::string& path, const std::vector<std::vector<uint32_t>>& sets, const Labels& labels) {
+    std::ofstream out(path);
+    for (const auto& set : sets) {
+        for (size_t k = 0; k < set.size(); ++k) out << (k ? " " : "") << labels[set[k]];
+        out << '\n';
+    }
+    if (!out) throw std::runtime_error(path + ": write failed");
+}
+
+// `m` with rows and columns reordered to `labels`, matched by label
+Matrix align_to(const Matrix& m, const Labels& labels, const std::string& what) {
+    if (m.row_labels.names == labels.names && m.col_labels.names == labels.names) return m;
+    size_t n = labels.size();
+    std::vector<int64_t> row(n), col(n);
+    for (size_t i = 0; i < n; ++i) {
+        row[i] = m.row_labels.find(labels[i]);
+        col[i] = m.col_labels.find(labels[i]);
+        if (row[i] < 0 || col[i] < 0) throw std::runtime_error(what + " has no row or column for " + labels[i]);
+    }
+    std::vector<double> values(n * n);
+    for (size_t i = 0; i < n; ++i)
+        for (size_t j = 0; j < n; ++j) values[i * n + j] = m.at(row[i], col[j]);
+    Matrix out;
+    out.rows = out.cols = n;
+    out.row_labels = out.col_labels = labels;
+    out.values = Buffer<double>(std::move(values));
+    return out;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    try {
+        Args args(argc, argv);
+        std::string out = args.get("out");
+        std::string method = args.get("method", "tmfg");
+        CliqueForest forest;
+        Labels labels;
+        if (args.has("candidates")) {
+            if (method != "tmfg") throw std::runtime_error("--candidates supports --method tmfg only");
+            Csr candidates = load_csr(args.get("candidates"));
+            labels = candidates.row_labels;
+            std::cout << "Candidates: " << candidates.rows << " nodes, " << candidates.nnz() << " arcs" << std::endl;
+            Matrix dense;
+            std::vector<float> profiles;
+            std::vector<uint32_t> row;  // candidate node -> row of --weights / --rca
+            size_t dim = 0;
+            if (args.has("weights")) {
+                dense = load_matrix(args.get("weights"));
+                row = remap_labels(labels, dense.row_labels);
+                if (dense.row_labels.size() != dense.rows) throw std::runtime_error("candidate nodes missing from --weights");
+            } else {
+                Matrix rca = load_matrix(args.get("rca"));
+                row = remap_labels(labels, rca.row_labels);
+                if (rca.row_labels.size() != rca.rows) throw std::runtime_error("candidate nodes missing from --rca");
+                profiles = correlation_profiles(rca);
+                dim = rca.cols;
+            }
+            size_t lookups = 0;
+            forest = tmfg_sparse(candidates, [&](uint32_t u, uint32_t v) {
+#pragma omp atomic
+                ++lookups;
+                if (!profiles.empty()) {
+                    const float* a = &profiles[size_t(row[u]) * dim];
+                    const float* b = &profiles[size_t(row[v]) * dim];
+                    double dot = 0;
+#pragma omp simd reduction(+ : dot)
+                    for (size_t f = 0; f < dim; ++f) dot += a[f] * b[f];
+                    return dot;
+                }
+                return dense.at(row[u], row[v]);
+            });
+            std::cout << "Exact lookups: " << lookups << std::endl;
+        } else {
+            Matrix weights = load_matrix(args.get("weights"));
+            labels = weights.row_labels;
+            std::cout << "Weights: " << weights.rows << " x " << weights.cols << std::endl;
+            if (method == "tmfg" && args.has("seeds")) {
+                std::vector<double> scores;
+                forest = tmfg_restarts(weights, args.integer("seeds", 1), args.integer("seed-pool", 8), scores);
+                std::ofstream seeds(out + "_seeds.csv");
+                seeds << "seed,total_weight\n";
+                seeds.precision(12);
+                for (size_t s = 0; s < scores.size(); ++s) seeds << s << ',' << scores[s] << '\n';
+            } else if (method == "tmfg") {
+                forest = tmfg(weights);
+            } else if (method == "mfcf") {
+                MfcfParams params;
+                params.max_clique = args.integer("max-clique", params.max_clique);
+                params.threshold = args.number("threshold", params.threshold);
+                forest = mfcf(weights, params);
+            } else {
+                throw std::runtime_error("unknown --method " + method);
+            }
+        }
+        std::cout << method << ": " << forest.edges.keys.size() << " edges, " << forest.cliques.size()
+                  << " cliques, total weight " << forest.total_weight << std::endl;
+
+        save_csr(out + ".csr", csr_from_edges(labels, forest.edges));
+        write_sets(out + "_cliques.txt", forest.cliques, labels);
+        write_sets(out + "_separators.txt", forest.separators, labels);
+
+        if (args.has("cov")) {
+            // Matched to the filtered nodes by label, whatever the file's order
+            Matrix cov = align_to(load_matrix(args.get("cov")), labels, "covariance");
+            Csr precision = logo(cov, forest);
+            save_csr(out + "_logo.csr", precision);
+            save_csr(out + "_partial.csr", partial_correlations(precision));
+            std::cout << "LoGo precision matrix saved to " << out << "_logo.csr" << std::endl;
+        }
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
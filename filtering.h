@@ -0,0 +1,68 @@
+#pragma once
+
+// Network filtering of dense similarity matrices (what filt_lib.py does with
+// fast_tmfg) and the sparse inverse covariance it enables.
+
+#include "edges.h"
+#include "netio.h"
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace cne {
+
+// Cliques and separators of a filtered graph, in insertion order, as
+// fast_tmfg reports them. `edges` are weighted by the input matrix.
+struct CliqueForest {
+    std::vector<std::vector<uint32_t>> cliques, separators;
+    EdgeList edges;
+    double total_weight = 0;
+};
+
+// Triangulated Maximally Filtered Graph (Massara, Di Matteo & Aste 2016):
+// starts from the 4-clique with the largest strength above the mean weight
+// and repeatedly inserts the vertex-face pair with the highest gain.
+// Seed 0 is the canonical run; other seeds draw the initial clique from the
+// `seed_pool` strongest vertices and break gain ties pseudo-randomly.
+struct TmfgParams {
+    uint64_t seed = 0;
+    size_t seed_pool = 8;
+};
+CliqueForest tmfg(const Matrix& weights, const TmfgParams& params = {});
+
+// Runs seeds 0 .. runs-1 concurrently on the shared matrix and returns the
+// result with the largest total edge weight; `scores` receives every run's.
+CliqueForest tmfg_restarts(const Matrix& weights, size_t runs, size_t seed_pool, std::vector<double>& scores);
+
+// TMFG without the dense matrix: face gains come from a sparse candidate
+// graph (e.g. top-k neighbours per node, symmetrised here) and `exact` is
+// asked only for pairs missing from the lists, or to scan every remaining
+// vertex when a face has no candidates left.
+using ExactWeight = std::function<double(uint32_t, uint32_t)>;
+CliqueForest tmfg_sparse(const Csr& candidates, const ExactWeight& exact);
+
+// Maximally Filtered Clique Forest (Massara & Aste 2019) with the sum-of-weights
+// gain, in its generalised form: a vertex links to the nodes of an existing
+// clique it has edges of at least `threshold` to (at most max_clique - 1 of
+// them). Linking to all of a clique below `max_clique` nodes grows it; linking
+// to part of one, or to a complete clique, makes a new clique on that
+// separator, which may be smaller than max_clique - 1 and may be shared. A new
+// component starts only when no remaining vertex qualifies anywhere, so the
+// result can be a forest. max_clique = 2 gives a maximum spanning forest.
+struct MfcfParams {
+    size_t max_clique = 4;
+    double threshold = 0.0;
+};
+CliqueForest mfcf(const Matrix& weights, const MfcfParams& params);
+
+// LoGo sparse inverse covariance (Barfuss et al. 2016):
+// J = sum over cliques of inv(cov_C) - sum over separators of inv(cov_S),
+// each embedded at its node ids. Only the clique and separator blocks are
+// inverted. Returns the precision matrix as a symmetric CSR with diagonal.
+Csr logo(const Matrix& cov, const CliqueForest& forest);
+
+// rho_ij = -J_ij / sqrt(J_ii J_jj) on the off-diagonal entries of `precision`.
+Csr partial_correlations(const Csr& precision);
+
+}  // namespace cne
@@ -0,0 +1,101 @@
+// Dynamic proximity: correlation of annual employment growth across years.
+//
+//   growth --counts 2015=Data/cnae/2015/counts.csr ... --counts 2023=Data/cnae/2023/counts.csr
+//          --axis locations --out Data/prox/location_growth_corr.mat [--min-overlap 4] [--min-count 10]
+//   filter --weights Data/prox/location_growth_corr.mat --out results/loc_growth_tmfg
+//
+// Each location (--axis locations, row totals of the count matrices) or
+// activity (--axis activities, column totals) gets the series of log growth
+// rates ln(X_t+1 / X_t) between consecutive --counts years, in the order
+// given. A rate is missing when either year is below --min-count (default:
+// any positive count) or the node is absent. Pearson correlations are taken
+// pairwise over the years both nodes have; pairs with fewer than
+// --min-overlap shared rates (default 3) get 0.
+//
+// Writes a dense labelled .mat with unit diagonal, the input filter expects,
+// and with --overlap a second .mat of shared-rate counts.
+
+#include "cli.h"
+#include "netio.h"
+#include "pairwise.h"
+
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace cne;
+
+int main(int argc, char** argv) {
+    try {
+        Args args(argc, argv);
+        std::string axis = args.get("axis", "locations");
+        if (axis != "locations" && axis != "activities")
+            throw std::runtime_error("--axis must be locations or activities");
+        double min_count = args.number("min-count", 0.0);
+        size_t min_overlap = args.integer("min-overlap", 3);
+
+        // Node totals per year, aligned on the union of labels
+        Labels nodes;
+        std::vector<std::vector<double>> totals;  // [year][node]
+        std::vector<std::string> names;
+        for (const auto& spec : args.all("counts")) {
+            auto eq = spec.find('=');
+            if (eq == std::string::npos) throw std::runtime_error("expected YEAR=PATH, got " + spec);
+            Csr counts = load_csr(spec.substr(eq + 1));
+            bool rows = axis == "locations";
+            std::vector<uint32_t> map = remap_labels(rows ? counts.row_labels : counts.col_labels, nodes);
+            std::vector<double> total(map.size(), 0.0);
+            for (size_t r = 0; r < counts.rows; ++r)
+                for (uint64_t e = counts.offsets[r]; e < counts.offsets[r + 1]; ++e)
+                    total[rows ? r : counts.indices[e]] += counts.values[e];
+            std::vector<double> aligned(nodes.size(), 0.0);
+            for (size_t i = 0; i < map.size(); ++i) aligned[map[i]] = total[i];
+            totals.push_back(std::move(aligned));
+            names.push_back(spec.substr(0, eq));
+        }
+        if (totals.size() < 3) throw std::runtime_error("need at least 3 --counts years (2 growth rates)");
+        size_t n = nodes.size(), T = totals.size() - 1;
+        for (auto& year : totals) year.resize(n, 0.0);  // nodes first seen in later years
+
+        std::vector<double> rates(n * T, 0.0);
+        std::vector<uint8_t> present(n * T, 0);
+        size_t observed = 0;
+        for (size_t i = 0; i < n; ++i)
+            for (size_t t = 0; t < T; ++t) {
+                double a = totals[t][i], b = totals[t + 1][i];
+                if (a > 0 && b > 0 && a >= min_count && b >= min_count) {
+                    rates[i * T + t] = std::log(b / a);
+                    present[i * T + t] = 1;
+                    ++observed;
+                }
+            }
+        std::cout << n << " " << axis << ", " << T << " growth rates from " << names.front() << " to "
+                  << names.back() << " (" << 100.0 * observed / (n * T) << "% observed)" << std::endl;
+
+        std::vector<uint32_t> overlap;
+        Matrix corr;
+        corr.rows = corr.cols = n;
+        corr.row_labels = corr.col_labels = nodes;
+        corr.values = Buffer<double>(
+            pairwise_correlation(rates.data(), present.data(), n, T, min_overlap, args.has("overlap") ? &overlap : nullptr));
+        save_matrix(args.get("out"), corr);
+
+        size_t kept = 0;
+        for (size_t i = 0; i < n; ++i)
+            for (size_t j = i + 1; j < n; ++j) kept += corr.at(i, j) != 0;
+        std::cout << kept << " of " << n * (n - 1) / 2 << " pairs correlated; saved to " << args.get("out")
+                  << std::endl;
+        if (args.has("overlap")) {
+            Matrix counts;
+            counts.rows = counts.cols = n;
+            counts.row_labels = counts.col_labels = nodes;
+            counts.values = Buffer<double>(std::vector<double>(overlap.begin(), overlap.end()));
+            save_matrix(args.get("overlap"), counts);
+        }
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
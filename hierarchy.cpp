@@ -0,0 +1,146 @@
+#include "hierarchy.h"
+
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+#include <utility>
+
+namespace cne {
+
+namespace {
+
+struct Prefix {
+    size_t width;
+    const char* name;
+};
+
+// CNAE 2.0 sections by their first and last division
+char cnae_section(int division) {
+    static const struct {
+        int last;
+        char section;
+    } ranges[] = {{3, 'A'},  {9, 'B'},  {33, 'C'}, {35, 'D'}, {39, 'E'}, {43, 'F'}, {47, 'G'},
+                  {53, 'H'}, {56, 'I'}, {63, 'J'}, {66, 'K'}, {68, 'L'}, {75, 'M'}, {82, 'N'},
+                  {84, 'O'}, {85, 'P'}, {88, 'Q'}, {93, 'R'}, {96, 'S'}, {97, 'T'}, {99, 'U'}};
+    for (const auto& r : ranges)
+        if (division <= r.last) return r.section;
+    return '?';
+}
+
+}  // namespace
+
+std::vector<HierarchyLevel> activity_hierarchy(const Labels& activities, const std::string& scheme) {
+    static const std::vector<Prefix> cnae_prefixes = {{2, "division"}, {3, "group"}, {5, "class"}, {7, "subclass"}};
+    static const std::vector<Prefix> cbo_prefixes = {
+        {1, "big_group"}, {2, "main_subgroup"}, {3, "subgroup"}, {4, "family"}, {6, "occupation"}};
+    static const std::vector<size_t> cnae_finest = {5, 7}, cbo_finest = {6};  // code lengths a label may have
+    const std::vector<Prefix>* prefix_table;
+    const std::vector<size_t>* finest_table;
+    if (scheme == "cnae") {
+        prefix_table = &cnae_prefixes;
+        finest_table = &cnae_finest;
+    } else if (scheme == "cbo") {
+        prefix_table = &cbo_prefixes;
+        finest_table = &cbo_finest;
+    } else {
+        throw std::runtime_error("unknown hierarchy " + scheme + " (expected cnae or cbo)");
+    }
+    const std::vector<Prefix>& prefixes = *prefix_table;
+    const std::vector<size_t>& finest = *finest_table;
+
+    std::vector<std::string> codes(activities.size());
+    size_t width = 0;
+    for (size_t p = 0; p < activities.size(); ++p) {
+        for (char ch : activities[p])
+            if (std::isdigit(static_cast<unsigned char>(ch))) codes[p] += ch;
+        auto fit = std::find_if(finest.begin(), finest.end(), [&](size_t w) { return w >= codes[p].size(); });
+        if (codes[p].empty() || fit == finest.end())
+            throw std::runtime_error("activity " + activities[p] + " is not a " + scheme + " code");
+        codes[p].insert(0, *fit - codes[p].size(), '0');
+        if (width && width != codes[p].size())
+            throw std::runtime_error("activity codes mix levels of the " + scheme + " hierarchy");
+        width = codes[p].size();
+    }
+
+    std::vector<HierarchyLevel> levels;
+    for (size_t k = prefixes.size(); k-- > 0;) {
+        if (prefixes[k].width > width) continue;
+        HierarchyLevel level;
+        level.name = prefixes[k].name;
+        level.index.resize(activities.size());
+        for (size_t p = 0; p < activities.size(); ++p)
+            level.index[p] = prefixes[k].width == width ? level.labels.intern(activities[p])
+                                                        : level.labels.intern(codes[p].substr(0, prefixes[k].width));
+        levels.push_back(std::move(level));
+    }
+    if (scheme == "cnae") {
+        HierarchyLevel level;
+        level.name = "section";
+        level.index.resize(activities.size());
+        for (size_t p = 0; p < activities.size(); ++p)
+            level.index[p] = level.labels.intern(std::string(1, cnae_section(std::stoi(codes[p].substr(0, 2)))));
+        levels.push_back(std::move(level));
+    }
+    return levels;
+}
+
+std::vector<Csr> roll_up(const Csr& counts, const std::vector<HierarchyLevel>& levels) {
+    size_t L = levels.size();
+    for (const auto& level : levels)
+        if (level.index.size() != counts.cols) throw std::runtime_error("hierarchy does not match the count columns");
+
+    // cells[l][r]: row r at level l, by column
+    std::vector<std::vector<std::vector<std::pair<uint32_t, double>>>> cells(
+        L, std::vector<std::vector<std::pair<uint32_t, double>>>(counts.rows));
+#pragma omp parallel
+    {
+        std::vector<std::vector<double>> acc(L);
+        std::vector<std::vector<uint32_t>> touched(L);
+        for (size_t l = 0; l < L; ++l) acc[l].assign(levels[l].labels.size(), 0.0);
+#pragma omp for schedule(dynamic, 64)
+        for (uint64_t r = 0; r < counts.rows; ++r) {
+            for (uint64_t e = counts.offsets[r]; e < counts.offsets[r + 1]; ++e) {
+                double v = counts.values[e];
+                if (v == 0) continue;
+                for (size_t l = 0; l < L; ++l) {
+                    uint32_t q = levels[l].index[counts.indices[e]];
+                    if (acc[l][q] == 0) touched[l].push_back(q);
+                    acc[l][q] += v;
+                }
+            }
+            for (size_t l = 0; l < L; ++l) {
+                std::sort(touched[l].begin(), touched[l].end());
+                for (uint32_t q : touched[l]) {
+                    if (acc[l][q] != 0) cells[l][r].emplace_back(q, acc[l][q]);
+                    acc[l][q] = 0;
+                }
+                touched[l].clear();
+            }
+        }
+    }
+
+    std::vector<Csr> result(L);
+    for (size_t l = 0; l < L; ++l) {
+        std::vector<uint64_t> offsets(1, 0);
+        std::vector<uint32_t> indices;
+        std::vector<double> values;
+        for (const auto& row : cells[l]) {
+            for (const auto& [q, v] : row) {
+                indices.push_back(q);
+                values.push_back(v);
+            }
+            offsets.push_back(indices.size());
+        }
+        Csr& g = result[l];
+        g.rows = counts.rows;
+        g.cols = levels[l].labels.size();
+        g.row_labels = counts.row_labels;
+        g.col_labels = levels[l].labels;
+        g.offsets = Buffer<uint64_t>(std::move(offsets));
+        g.indices = Buffer<uint32_t>(std::move(indices));
+        g.values = Buffer<double>(std::move(values));
+    }
+    return result;
+}
+
+}  // namespace cne
@@ -0,0 +1,34 @@
+#pragma once
+
+// Code trees of the activity classifications, for rolling count matrices up
+// from the finest level RAIS reports to every coarser one:
+//   cnae  CNAE 2.0: section (letter, by division range), division (2 digits),
+//         group (3), class (5, with check digit), subclass (7)
+//   cbo   CBO 2002: big group (1 digit), main subgroup (2), subgroup (3),
+//         family (4), occupation (6)
+// Codes are read from the column labels with punctuation dropped ("1011-2",
+// "10112" and "1011.2" are the same class) and leading zeros restored when a
+// numeric export lost them ("1113" is class 01113).
+
+#include "netio.h"
+
+#include <string>
+#include <vector>
+
+namespace cne {
+
+struct HierarchyLevel {
+    std::string name;
+    Labels labels;                 // codes at this level
+    std::vector<uint32_t> index;  // finest activity id -> id in `labels`
+};
+
+// Levels from the finest (the codes of `activities` themselves) to the
+// coarsest. Throws on codes that do not fit the scheme.
+std::vector<HierarchyLevel> activity_hierarchy(const Labels& activities, const std::string& scheme);
+
+// Sums the columns of `counts` (locations x finest activities) into every
+// level in one pass over its non-zeros; result[l] has the columns of levels[l]
+std::vector<Csr> roll_up(const Csr& counts, const std::vector<HierarchyLevel>& levels);
+
+}  // namespace cne
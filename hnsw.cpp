@@ -0,0 +1,237 @@
+#include "hnsw.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <queue>
+#include <stdexcept>
+
+namespace cne {
+
+namespace {
+
+const char kHnswMagic[8] = {'C', 'N', 'E', 'H', 'N', 'S', 'W', '1'};
+
+using Entry = std::pair<float, uint32_t>;  // (distance, id) inside the graph code
+
+// Generation-stamped visited marks, reused by every search on a thread.
+class Visited {
+public:
+    void reset(size_t n) {
+        if (marks_.size() < n) marks_.assign(n, 0);
+        if (++generation_ == 0) {
+            std::fill(marks_.begin(), marks_.end(), 0);
+            generation_ = 1;
+        }
+    }
+    bool test_and_set(uint32_t id) {
+        if (marks_[id] == generation_) return true;
+        marks_[id] = generation_;
+        return false;
+    }
+
+private:
+    std::vector<uint32_t> marks_;
+    uint32_t generation_ = 0;
+};
+
+thread_local Visited visited;
+
+template <typename T>
+void put(std::ofstream& out, const T& v) { out.write(reinterpret_cast<const char*>(&v), sizeof(T)); }
+
+template <typename T>
+T get(std::ifstream& in) {
+    T v;
+    in.read(reinterpret_cast<char*>(&v), sizeof(T));
+    return v;
+}
+
+void put_labels(std::ofstream& out, const Labels& labels) {
+    for (const auto& name : labels.names) {
+        put<uint32_t>(out, name.size());
+        out.write(name.data(), name.size());
+    }
+}
+
+Labels get_labels(std::ifstream& in, size_t n) {
+    Labels labels;
+    for (size_t i = 0; i < n; ++i) {
+        std::string name(get<uint32_t>(in), '\0');
+        in.read(&name[0], name.size());
+        labels.intern(name);
+    }
+    return labels;
+}
+
+}  // namespace
+
+HnswIndex::HnswIndex(std::vector<float> vectors, size_t dim, Labels labels, Labels features, Params params)
+    : dim_(dim), params_(params), labels_(std::move(labels)), features_(std::move(features)),
+      vectors_(std::move(vectors)) {
+    if (vectors_.size() != labels_.size() * dim_) throw std::runtime_error("hnsw: vector/label count mismatch");
+    size_t n = labels_.size();
+    links_.resize(n);
+
+    Rng rng(params_.seed);
+    double ml = 1.0 / std::log(double(std::max(params_.M, 2)));
+    for (uint32_t id = 0; id < n; ++id) {
+        int level = int(-std::log(1.0 - rng.uniform()) * ml);
+        insert(id, level);
+    }
+}
+
+float HnswIndex::distance(const float* a, const float* b) const {
+    float dot = 0;
+#pragma omp simd reduction(+ : dot)
+    for (size_t j = 0; j < dim_; ++j) dot += a[j] * b[j];
+    return 1.0f - dot;
+}
+
+// Best-first search of one level; returns up to ef entries as (distance, id), nearest first.
+HnswIndex::Results HnswIndex::search_layer(const float* query, const Results& entry, size_t ef, int level) const {
+    visited.reset(size());
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> candidates;
+    std::priority_queue<Entry> found;  // farthest on top
+    for (const auto& e : entry) {
+        visited.test_and_set(e.second);
+        candidates.push(e);
+        found.push(e);
+    }
+    while (found.size() > ef) found.pop();
+
+    while (!candidates.empty()) {
+        Entry c = candidates.top();
+        if (c.first > found.top().first && found.size() >= ef) break;
+        candidates.pop();
+        for (uint32_t nb : links_[c.second][level]) {
+            if (visited.test_and_set(nb)) continue;
+            float d = distance(query, vector(nb));
+            if (found.size() < ef || d < found.top().first) {
+                candidates.emplace(d, nb);
+                found.emplace(d, nb);
+                if (found.size() > ef) found.pop();
+            }
+        }
+    }
+
+    Results out(found.size());
+    for (size_t i = found.size(); i-- > 0; found.pop()) out[i] = found.top();
+    return out;
+}
+
+// Keeps a candidate only if it is closer to the query than to every neighbour
+// already kept, which spreads links across directions.
+std::vector<uint32_t> HnswIndex::select_neighbors(const Results& candidates, size_t m) const {
+    std::vector<uint32_t> kept;
+    for (const auto& c : candidates) {
+        if (kept.size() >= m) break;
+        bool good = true;
+        for (uint32_t r : kept)
+            if (distance(vector(c.second), vector(r)) < c.first) {
+                good = false;
+                break;
+            }
+        if (good) kept.push_back(c.second);
+    }
+    return kept;
+}
+
+void HnswIndex::insert(uint32_t id, int level) {
+    links_[id].resize(level + 1);
+    if (max_level_ < 0) {
+        max_level_ = level;
+        entry_ = id;
+        return;
+    }
+
+    const float* q = vector(id);
+    Results eps{{distance(q, vector(entry_)), entry_}};
+    for (int l = max_level_; l > level; --l) eps = search_layer(q, eps, 1, l);
+
+    for (int l = std::min(level, max_level_); l >= 0; --l) {
+        eps = search_layer(q, eps, params_.ef_construction, l);
+        size_t cap = l == 0 ? 2 * params_.M : params_.M;
+        links_[id][l] = select_neighbors(eps, params_.M);
+
+        for (uint32_t nb : links_[id][l]) {
+            auto& list = links_[nb][l];
+            list.push_back(id);
+            if (list.size() <= cap) continue;
+            Results cand;
+            for (uint32_t x : list) cand.emplace_back(distance(vector(nb), vector(x)), x);
+            std::sort(cand.begin(), cand.end());
+            list = select_neighbors(cand, cap);
+        }
+    }
+    if (level > max_level_) {
+        max_level_ = level;
+        entry_ = id;
+    }
+}
+
+HnswIndex::Results HnswIndex::search(const float* query, size_t k, size_t ef) const {
+    if (max_level_ < 0) return {};
+    Results eps{{distance(query, vector(entry_)), entry_}};
+    for (int l = max_level_; l > 0; --l) eps = search_layer(query, eps, 1, l);
+    eps = search_layer(query, eps, std::max(ef, k), 0);
+    eps.resize(std::min(k, eps.size()));
+    for (auto& e : eps) e.first = 1.0f - e.first;
+    return eps;
+}
+
+void HnswIndex::save(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) throw std::runtime_error(path + ": cannot open for writing");
+    out.write(kHnswMagic, 8);
+    put<uint64_t>(out, size());
+    put<uint64_t>(out, dim_);
+    put<int32_t>(out, params_.M);
+    put<int32_t>(out, params_.ef_construction);
+    put<int32_t>(out, max_level_);
+    put<uint32_t>(out, entry_);
+    put_labels(out, labels_);
+    put_labels(out, features_);
+    out.write(reinterpret_cast<const char*>(vectors_.data()), vectors_.size() * sizeof(float));
+    for (const auto& levels : links_) {
+        put<uint32_t>(out, levels.size());
+        for (const auto& list : levels) {
+            put<uint32_t>(out, list.size());
+            out.write(reinterpret_cast<const char*>(list.data()), list.size() * sizeof(uint32_t));
+        }
+    }
+    if (!out) throw std::runtime_error(path + ": write failed");
+}
+
+HnswIndex HnswIndex::load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) throw std::runtime_error(path + ": cannot open");
+    char magic[8];
+    in.read(magic, 8);
+    if (!in || std::memcmp(magic, kHnswMagic, 8) != 0) throw std::runtime_error(path + ": not an HNSW index");
+
+    HnswIndex index;
+    size_t n = get<uint64_t>(in);
+    index.dim_ = get<uint64_t>(in);
+    index.params_.M = get<int32_t>(in);
+    index.params_.ef_construction = get<int32_t>(in);
+    index.max_level_ = get<int32_t>(in);
+    index.entry_ = get<uint32_t>(in);
+    index.labels_ = get_labels(in, n);
+    index.features_ = get_labels(in, index.dim_);
+    index.vectors_.resize(n * index.dim_);
+    in.read(reinterpret_cast<char*>(index.vectors_.data()), index.vectors_.size() * sizeof(float));
+    index.links_.resize(n);
+    for (auto& levels : index.links_) {
+        levels.resize(get<uint32_t>(in));
+        for (auto& list : levels) {
+            list.resize(get<uint32_t>(in));
+            in.read(reinterpret_cast<char*>(list.data()), list.size() * sizeof(uint32_t));
+        }
+    }
+    if (!in) throw std::runtime_error(path + ": truncated index");
+    return index;
+}
+
+}  // namespace cne
@@ -0,0 +1,57 @@
+#pragma once
+
+// Hierarchical navigable small world graph (Malkov & Yashunin) over unit
+// vectors, searched by inner product. With correlation_profiles() as input
+// the returned similarity is the Pearson correlation of the RCA profiles.
+
+#include "netio.h"
+#include "rng.h"
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace cne {
+
+class HnswIndex {
+public:
+    struct Params {
+        int M = 16;                 // links per node on upper levels, 2M on level 0
+        int ef_construction = 200;  // candidate list size while inserting
+        uint64_t seed = 42;
+    };
+
+    // (similarity, node id), best first
+    using Results = std::vector<std::pair<float, uint32_t>>;
+
+    HnswIndex(std::vector<float> vectors, size_t dim, Labels labels, Labels features, Params params);
+    static HnswIndex load(const std::string& path);
+    void save(const std::string& path) const;
+
+    Results search(const float* query, size_t k, size_t ef) const;
+
+    size_t size() const { return labels_.size(); }
+    size_t dim() const { return dim_; }
+    const Labels& labels() const { return labels_; }
+    const Labels& features() const { return features_; }
+    const float* vector(uint32_t id) const { return &vectors_[size_t(id) * dim_]; }
+
+private:
+    HnswIndex() = default;
+
+    float distance(const float* a, const float* b) const;
+    Results search_layer(const float* query, const Results& entry, size_t ef, int level) const;
+    std::vector<uint32_t> select_neighbors(const Results& candidates, size_t m) const;
+    void insert(uint32_t id, int level);
+
+    size_t dim_ = 0;
+    Params params_;
+    Labels labels_, features_;
+    std::vector<float> vectors_;
+    std::vector<std::vector<std::vector<uint32_t>>> links_;  // [node][level]
+    int max_level_ = -1;
+    uint32_t entry_ = 0;
+};
+
+}  // namespace cne
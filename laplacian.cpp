@@ -0,0 +1,311 @@
+#include "laplacian.h"
+
+#include "edges.h"
+#include "parallel.h"
+#include "rng.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace cne {
+
+namespace {
+
+double dot(const double* a, const double* b, size_t n) {
+    double s = 0;
+#pragma omp parallel for simd reduction(+ : s) schedule(static)
+    for (size_t i = 0; i < n; ++i) s += a[i] * b[i];
+    return s;
+}
+
+class Jacobi : public Preconditioner {
+public:
+    explicit Jacobi(std::vector<double> inverse) : inverse_(std::move(inverse)) {}
+    void apply(const double* r, double* z, size_t cols) const override {
+        size_t n = inverse_.size();
+#pragma omp parallel for schedule(static)
+        for (size_t i = 0; i < n; ++i)
+            for (size_t j = 0; j < cols; ++j) z[j * n + i] = inverse_[i] * r[j * n + i];
+    }
+
+private:
+    std::vector<double> inverse_;
+};
+
+// Lower triangular factor in CSR, each row ending with its diagonal
+class IncompleteCholesky : public Preconditioner {
+public:
+    IncompleteCholesky(std::vector<uint64_t> offsets, std::vector<uint32_t> indices, std::vector<double> values)
+        : offsets_(std::move(offsets)), indices_(std::move(indices)), values_(std::move(values)) {}
+
+    void apply(const double* r, double* z, size_t cols) const override {
+        size_t n = offsets_.size() - 1;
+        // Triangular solves are sequential; columns are independent
+#pragma omp parallel for schedule(dynamic, 1)
+        for (size_t j = 0; j < cols; ++j) {
+            double* y = z + j * n;
+            const double* rj = r + j * n;
+            for (size_t i = 0; i < n; ++i) {
+                double s = rj[i];
+                uint64_t diag = offsets_[i + 1] - 1;
+                for (uint64_t e = offsets_[i]; e < diag; ++e) s -= values_[e] * y[indices_[e]];
+                y[i] = s / values_[diag];
+            }
+            for (size_t i = n; i-- > 0;) {
+                uint64_t diag = offsets_[i + 1] - 1;
+                y[i] /= values_[diag];
+                for (uint64_t e = offsets_[i]; e < diag; ++e) y[indices_[e]] -= values_[e] * y[i];
+            }
+        }
+    }
+
+private:
+    std::vector<uint64_t> offsets_;
+    std::vector<uint32_t> indices_;
+    std::vector<double> values_;
+};
+
+void check_adjacency(const Csr& g) {
+    if (g.rows != g.cols) throw std::runtime_error("laplacian: adjacency must be square");
+    for (uint64_t e = 0; e < g.nnz(); ++e)
+        if (g.values[e] < 0) throw std::runtime_error("laplacian: negative edge weight");
+}
+
+}  // namespace
+
+CsrLaplacian::CsrLaplacian(const Csr& adjacency) : g_(adjacency), degrees_(adjacency.rows, 0.0) {
+    check_adjacency(g_);
+    for (uint64_t i = 0; i < g_.rows; ++i)
+        for (uint64_t e = g_.offsets[i]; e < g_.offsets[i + 1]; ++e)
+            if (g_.indices[e] != i) degrees_[i] += g_.values[e];
+}
+
+void CsrLaplacian::apply(const double* x, double* y, size_t cols, double shift) const {
+    size_t n = g_.rows;
+#pragma omp parallel for schedule(dynamic, 256)
+    for (size_t i = 0; i < n; ++i)
+        for (size_t j = 0; j < cols; ++j) {
+            const double* xj = x + j * n;
+            double s = (degrees_[i] + shift) * xj[i];
+            for (uint64_t e = g_.offsets[i]; e < g_.offsets[i + 1]; ++e)
+                if (g_.indices[e] != i) s -= g_.values[e] * xj[g_.indices[e]];
+            y[j * n + i] = s;
+        }
+}
+
+void CsrLaplacian::for_each_edge(uint32_t u, const std::function<void(uint32_t, double)>& f) const {
+    for (uint64_t e = g_.offsets[u]; e < g_.offsets[u + 1]; ++e)
+        if (g_.indices[e] > u && g_.values[e] > 0) f(g_.indices[e], g_.values[e]);
+}
+
+TriangleLaplacian::TriangleLaplacian(const Triangle& weights) : t_(weights), degrees_(weights.n, 0.0) {
+    std::vector<double> ones(t_.n, 1.0);
+    apply(ones.data(), degrees_.data(), 1, 0.0);  // degrees_ is still zero: y = -A 1
+    for (double& d : degrees_) d = -d;
+}
+
+void TriangleLaplacian::apply(const double* x, double* y, size_t cols, double shift) const {
+    size_t n = t_.n;
+    size_t threads = thread_count();
+    // acc_[t] collects the lower-triangle contributions w_ij x_i to rows j > i.
+    // Allocated on first use and left zeroed by the reduction below, so calls
+    // neither allocate nor clear it.
+    if (acc_.size() < threads * n * cols) acc_.assign(threads * n * cols, 0.0);
+    double* acc = acc_.data();
+#pragma omp parallel for schedule(dynamic, 16)
+    for (size_t i = 0; i < n; ++i) {
+        const double* w = t_.row(i);
+        double* lower = acc + size_t(thread_id()) * n * cols;
+        for (size_t c = 0; c < cols; ++c) {
+            const double* xc = x + c * n;
+            double* lc = lower + c * n;
+            double xi = xc[i], s = 0;
+#pragma omp simd reduction(+ : s)
+            for (size_t j = i + 1; j < n; ++j) {
+                double wij = w[j - i - 1] > 0 ? w[j - i - 1] : 0.0;
+                s += wij * xc[j];
+                lc[j] += wij * xi;
+            }
+            y[c * n + i] = (degrees_[i] + shift) * xi - s;
+        }
+    }
+#pragma omp parallel for schedule(static)
+    for (size_t k = 0; k < n * cols; ++k) {
+        double s = 0;
+        for (size_t t = 0; t < threads; ++t) {
+            s += acc[t * n * cols + k];
+            acc[t * n * cols + k] = 0;
+        }
+        y[k] -= s;
+    }
+}
+
+void TriangleLaplacian::for_each_edge(uint32_t u, const std::function<void(uint32_t, double)>& f) const {
+    const double* w = t_.row(u);
+    for (uint64_t v = u + 1; v < t_.n; ++v)
+        if (w[v - u - 1] > 0) f(uint32_t(v), w[v - u - 1]);
+}
+
+std::unique_ptr<Preconditioner> jacobi_preconditioner(const LaplacianOperator& op, double shift) {
+    std::vector<double> inverse(op.size());
+    for (size_t i = 0; i < inverse.size(); ++i) {
+        double d = op.degrees()[i] + shift;
+        inverse[i] = d > 0 ? 1 / d : 1.0;
+    }
+    return std::make_unique<Jacobi>(std::move(inverse));
+}
+
+std::unique_ptr<Preconditioner> incomplete_cholesky(const Csr& g, double shift) {
+    check_adjacency(g);
+    size_t n = g.rows;
+    std::vector<uint64_t> offsets(n + 1, 0);
+    std::vector<uint32_t> indices;
+    std::vector<double> a, diagonal(n, shift);
+    std::vector<std::pair<uint32_t, double>> row;
+    for (size_t i = 0; i < n; ++i) {
+        row.clear();
+        for (uint64_t e = g.offsets[i]; e < g.offsets[i + 1]; ++e) {
+            uint32_t j = g.indices[e];
+            if (j == i) continue;
+            diagonal[i] += g.values[e];
+            if (j < i) row.emplace_back(j, -g.values[e]);
+        }
+        std::sort(row.begin(), row.end());
+        for (const auto& [j, value] : row) indices.push_back(j), a.push_back(value);
+        indices.push_back(uint32_t(i));
+        a.push_back(0.0);
+        offsets[i + 1] = indices.size();
+    }
+
+    std::vector<double> l(a.size()), work(n, 0.0);
+    for (double boost = 0;; boost = boost ? boost * 10 : 1e-4) {
+        if (boost > 1) throw std::runtime_error("laplacian: incomplete Cholesky failed");
+        bool ok = true;
+        for (size_t i = 0; i < n && ok; ++i) {
+            uint64_t diag = offsets[i + 1] - 1;
+            // l_ij = (a_ij - sum_k<j l_ik l_jk) / l_jj, with row i's finished
+            // entries scattered into `work`
+            double sum = 0;
+            for (uint64_t e = offsets[i]; e < diag; ++e) {
+                uint32_t j = indices[e];
+                double s = a[e];
+                for (uint64_t f = offsets[j]; f + 1 < offsets[j + 1]; ++f) s -= l[f] * work[indices[f]];
+                l[e] = s / l[offsets[j + 1] - 1];
+                work[j] = l[e];
+                sum += l[e] * l[e];
+            }
+            for (uint64_t e = offsets[i]; e < diag; ++e) work[indices[e]] = 0;
+            double d = diagonal[i] * (1 + boost);
+            if (d == 0) {
+                l[diag] = 1;  // isolated node
+            } else if (d - sum > 1e-12 * d) {
+                l[diag] = std::sqrt(d - sum);
+            } else {
+                ok = false;
+            }
+        }
+        if (ok) break;
+    }
+    return std::make_unique<IncompleteCholesky>(std::move(offsets), std::move(indices), std::move(l));
+}
+
+PcgStats solve_laplacian(const LaplacianOperator& op, const Preconditioner& m, const std::vector<double>& b,
+                         size_t cols, std::vector<double>& x, const PcgParams& params) {
+    size_t n = op.size();
+    if (b.size() != n * cols) throw std::runtime_error("laplacian: right-hand side size mismatch");
+    x.assign(n * cols, 0.0);
+    PcgStats stats;
+    size_t block = std::max<size_t>(params.block, 1);
+
+    for (size_t first = 0; first < cols; first += block) {
+        size_t c = std::min(block, cols - first);
+        std::vector<double> r(b.begin() + first * n, b.begin() + (first + c) * n), z(n * c), p(n * c), q(n * c);
+        std::vector<double> rz(c), norm_b(c);
+        std::vector<char> active(c, 1);
+        double* xb = &x[first * n];
+        m.apply(r.data(), z.data(), c);
+        p = z;
+        for (size_t j = 0; j < c; ++j) {
+            rz[j] = dot(&r[j * n], &z[j * n], n);
+            norm_b[j] = std::sqrt(dot(&r[j * n], &r[j * n], n));
+            if (norm_b[j] == 0) active[j] = 0;
+        }
+
+        size_t it = 0;
+        for (; std::count(active.begin(), active.end(), 1) && it < params.max_iterations; ++it) {
+            op.apply(p.data(), q.data(), c, params.shift);
+            for (size_t j = 0; j < c; ++j) {
+                if (!active[j]) continue;
+                double* pj = &p[j * n];
+                double* qj = &q[j * n];
+                double* rj = &r[j * n];
+                double* xj = xb + j * n;
+                double alpha = rz[j] / dot(pj, qj, n);
+#pragma omp parallel for simd schedule(static)
+                for (size_t i = 0; i < n; ++i) {
+                    xj[i] += alpha * pj[i];
+                    rj[i] -= alpha * qj[i];
+                }
+                if (std::sqrt(dot(rj, rj, n)) <= params.tolerance * norm_b[j]) active[j] = 0;
+            }
+            m.apply(r.data(), z.data(), c);
+            for (size_t j = 0; j < c; ++j) {
+                if (!active[j]) {
+                    std::fill(p.begin() + j * n, p.begin() + (j + 1) * n, 0.0);
+                    continue;
+                }
+                double next = dot(&r[j * n], &z[j * n], n);
+                double beta = next / rz[j];
+                rz[j] = next;
+                double* pj = &p[j * n];
+                const double* zj = &z[j * n];
+#pragma omp parallel for simd schedule(static)
+                for (size_t i = 0; i < n; ++i) pj[i] = zj[i] + beta * pj[i];
+            }
+        }
+        stats.iterations = std::max(stats.iterations, it);
+        for (size_t j = 0; j < c; ++j) {
+            stats.unconverged += active[j];
+            if (norm_b[j] > 0)
+                stats.residual = std::max(stats.residual, std::sqrt(dot(&r[j * n], &r[j * n], n)) / norm_b[j]);
+        }
+    }
+    return stats;
+}
+
+std::vector<double> resistance_sketch(const LaplacianOperator& op, const Preconditioner& m, size_t k, uint64_t seed,
+                                      const PcgParams& params, PcgStats& stats) {
+    size_t n = op.size();
+    // Row s of Q W^1/2 B: each edge u < v adds +-sqrt(w / k) at u and the
+    // opposite at v. The sign is bit s % 64 of a hash of the edge and s / 64,
+    // so a task covering 8 consecutive rows hashes each edge once.
+    std::vector<double> y(n * k, 0.0);
+    double scale = 1 / std::sqrt(double(k));
+#pragma omp parallel for schedule(dynamic, 1)
+    for (size_t first = 0; first < k; first += 8) {
+        size_t count = std::min<size_t>(8, k - first);
+        uint64_t salt = mix64(seed + first / 64);
+        for (uint32_t u = 0; u < n; ++u)
+            op.for_each_edge(u, [&](uint32_t v, double w) {
+                uint64_t bits = mix64(edge_key(u, v) ^ salt) >> (first % 64);
+                double a = std::sqrt(w) * scale;
+                for (size_t s = 0; s < count; ++s) {
+                    double signed_a = (bits >> s) & 1 ? a : -a;
+                    y[(first + s) * n + u] += signed_a;
+                    y[(first + s) * n + v] -= signed_a;
+                }
+            });
+    }
+    std::vector<double> z;
+    PcgParams singular = params;
+    singular.shift = 0;
+    stats = solve_laplacian(op, m, y, k, z, singular);
+
+    std::vector<double> coords(n * k);
+    for (size_t i = 0; i < n; ++i)
+        for (size_t s = 0; s < k; ++s) coords[i * k + s] = z[s * n + i];
+    return coords;
+}
+
+}  // namespace cne
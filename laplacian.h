@@ -0,0 +1,102 @@
+#pragma once
+
+// Laplacian solves on filtered networks: (L + shift I) X = B by
+// preconditioned conjugate gradients, for graph smoothing and effective
+// resistances. L = D - A for a symmetric adjacency with non-negative weights;
+// self-loops are ignored.
+//
+// Blocks of vectors are stored column by column: column j at [j * n].
+
+#include "netio.h"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace cne {
+
+class LaplacianOperator {
+public:
+    virtual ~LaplacianOperator() = default;
+    virtual size_t size() const = 0;
+    // y = (L + shift I) x for `cols` vectors
+    virtual void apply(const double* x, double* y, size_t cols, double shift) const = 0;
+    // Weighted degrees, the diagonal of L
+    virtual const std::vector<double>& degrees() const = 0;
+    // Calls f(v, w) for every edge (u, v) with v > u and w > 0
+    virtual void for_each_edge(uint32_t u, const std::function<void(uint32_t, double)>& f) const = 0;
+};
+
+class CsrLaplacian : public LaplacianOperator {
+public:
+    explicit CsrLaplacian(const Csr& adjacency);
+    size_t size() const override { return g_.rows; }
+    void apply(const double* x, double* y, size_t cols, double shift) const override;
+    const std::vector<double>& degrees() const override { return degrees_; }
+    void for_each_edge(uint32_t u, const std::function<void(uint32_t, double)>& f) const override;
+    const Csr& graph() const { return g_; }
+
+private:
+    const Csr& g_;
+    std::vector<double> degrees_;
+};
+
+// Complete graph of a dense symmetric weight matrix stored as a .tri; entries
+// <= 0 (or NaN) are not edges. Products use per-thread accumulators since
+// each stored entry feeds two rows; they are kept in the object, so apply()
+// must not be called concurrently on one instance.
+class TriangleLaplacian : public LaplacianOperator {
+public:
+    explicit TriangleLaplacian(const Triangle& weights);
+    size_t size() const override { return t_.n; }
+    void apply(const double* x, double* y, size_t cols, double shift) const override;
+    const std::vector<double>& degrees() const override { return degrees_; }
+    void for_each_edge(uint32_t u, const std::function<void(uint32_t, double)>& f) const override;
+
+private:
+    const Triangle& t_;
+    std::vector<double> degrees_;
+    mutable std::vector<double> acc_;  // threads x n x cols, zero between calls
+};
+
+class Preconditioner {
+public:
+    virtual ~Preconditioner() = default;
+    // z = M^-1 r for `cols` vectors
+    virtual void apply(const double* r, double* z, size_t cols) const = 0;
+};
+
+// Diagonal of L + shift I; isolated nodes get 1.
+std::unique_ptr<Preconditioner> jacobi_preconditioner(const LaplacianOperator& op, double shift);
+
+// IC(0) factor of L + shift I on the adjacency pattern. The diagonal is
+// raised by a growing relative amount until every pivot is positive, which
+// always succeeds for shift = 0 (L singular) too.
+std::unique_ptr<Preconditioner> incomplete_cholesky(const Csr& adjacency, double shift);
+
+struct PcgParams {
+    double shift = 0;
+    double tolerance = 1e-8;  // on ||r|| / ||b||, per column
+    size_t max_iterations = 2000;
+    size_t block = 16;  // columns that advance together, sharing each pass over the graph
+};
+struct PcgStats {
+    size_t iterations = 0;   // most taken by any column
+    double residual = 0;     // largest relative residual at exit
+    size_t unconverged = 0;  // columns that hit max_iterations
+};
+
+// Solves (L + shift I) X = B; x receives n x cols values. With shift = 0 each
+// column of B must sum to zero over every connected component.
+PcgStats solve_laplacian(const LaplacianOperator& op, const Preconditioner& m, const std::vector<double>& b,
+                         size_t cols, std::vector<double>& x, const PcgParams& params);
+
+// Effective resistance embedding (Spielman & Srivastava 2008): Z = Q W^1/2 B L^+
+// with a random +-1/sqrt(k) projection Q of the edges onto k dimensions, so
+// that R_uv ~ ||z_u - z_v||^2 within 1 +- eps for k ~ 24 log(n) / eps^2.
+// Returns n x k row-major coordinates. Only meaningful within a component.
+std::vector<double> resistance_sketch(const LaplacianOperator& op, const Preconditioner& m, size_t k, uint64_t seed,
+                                      const PcgParams& params, PcgStats& stats);
+
+}  // namespace cne
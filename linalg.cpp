@@ -0,0 +1,89 @@
+#include "linalg.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+namespace cne {
+
+bool invert_spd(double* a, size_t n) {
+    // A = L L^T, with L stored in the lower triangle of `l`
+    std::vector<double> l(n * n, 0.0);
+    for (size_t j = 0; j < n; ++j) {
+        double d = a[j * n + j];
+        for (size_t k = 0; k < j; ++k) d -= l[j * n + k] * l[j * n + k];
+        if (!(d > 0)) return false;
+        l[j * n + j] = std::sqrt(d);
+        for (size_t i = j + 1; i < n; ++i) {
+            double s = a[i * n + j];
+            for (size_t k = 0; k < j; ++k) s -= l[i * n + k] * l[j * n + k];
+            l[i * n + j] = s / l[j * n + j];
+        }
+    }
+
+    // L^-1 by forward substitution, then A^-1 = L^-T L^-1
+    std::vector<double> inv(n * n, 0.0);
+    for (size_t j = 0; j < n; ++j) {
+        inv[j * n + j] = 1.0 / l[j * n + j];
+        for (size_t i = j + 1; i < n; ++i) {
+            double s = 0;
+            for (size_t k = j; k < i; ++k) s -= l[i * n + k] * inv[k * n + j];
+            inv[i * n + j] = s / l[i * n + i];
+        }
+    }
+    for (size_t i = 0; i < n; ++i)
+        for (size_t j = 0; j <= i; ++j) {
+            double s = 0;
+            for (size_t k = i; k < n; ++k) s += inv[k * n + i] * inv[k * n + j];
+            a[i * n + j] = a[j * n + i] = s;
+        }
+    return true;
+}
+
+void symmetric_eigen(double* a, size_t n, double* values, double* vectors) {
+    std::vector<double> v(n * n, 0.0);
+    for (size_t i = 0; i < n; ++i) v[i * n + i] = 1.0;
+
+    for (int sweep = 0; sweep < 100; ++sweep) {
+        double off = 0, scale = 0;
+        for (size_t i = 0; i < n; ++i)
+            for (size_t j = 0; j < n; ++j) (i == j ? scale : off) += a[i * n + j] * a[i * n + j];
+        if (off <= 1e-30 * std::max(scale, 1e-300)) break;
+
+        for (size_t p = 0; p + 1 < n; ++p)
+            for (size_t q = p + 1; q < n; ++q) {
+                double apq = a[p * n + q];
+                if (apq == 0) continue;
+                // Rotation that zeroes a[p][q]
+                double theta = (a[q * n + q] - a[p * n + p]) / (2 * apq);
+                double t = (theta >= 0 ? 1 : -1) / (std::abs(theta) + std::sqrt(theta * theta + 1));
+                double c = 1 / std::sqrt(t * t + 1), s = t * c;
+                for (size_t k = 0; k < n; ++k) {
+                    double akp = a[k * n + p], akq = a[k * n + q];
+                    a[k * n + p] = c * akp - s * akq;
+                    a[k * n + q] = s * akp + c * akq;
+                }
+                for (size_t k = 0; k < n; ++k) {
+                    double apk = a[p * n + k], aqk = a[q * n + k];
+                    a[p * n + k] = c * apk - s * aqk;
+                    a[q * n + k] = s * apk + c * aqk;
+                }
+                for (size_t k = 0; k < n; ++k) {
+                    double vkp = v[k * n + p], vkq = v[k * n + q];
+                    v[k * n + p] = c * vkp - s * vkq;
+                    v[k * n + q] = s * vkp + c * vkq;
+                }
+            }
+    }
+
+    std::vector<size_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](size_t x, size_t y) { return a[x * n + x] < a[y * n + y]; });
+    for (size_t j = 0; j < n; ++j) {
+        values[j] = a[order[j] * n + order[j]];
+        for (size_t i = 0; i < n; ++i) vectors[i * n + j] = v[i * n + order[j]];
+    }
+}
+
+}  // namespace cne
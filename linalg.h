@@ -0,0 +1,19 @@
+#pragma once
+
+// Small dense linear algebra on row-major blocks, for the per-clique and
+// per-subspace problems the graph tools solve many times.
+
+#include <cstddef>
+
+namespace cne {
+
+// Inverts a symmetric positive definite n x n matrix in place through its
+// Cholesky factor. Returns false, leaving `a` unspecified, if it is not SPD.
+bool invert_spd(double* a, size_t n);
+
+// Eigen-decomposition of a symmetric n x n matrix by cyclic Jacobi rotations.
+// `values` receives the eigenvalues in ascending order and column j of the
+// row-major `vectors` the matching unit eigenvector. `a` is destroyed.
+void symmetric_eigen(double* a, size_t n, double* values, double* vectors);
+
+}  // namespace cne
@@ -0,0 +1,235 @@
+// Link prediction from one year's filtered network to the next.
+//
+//   linkpred --graph results/2022_loc_tmfg.csr --next results/2023_loc_tmfg.csr
+//            --out results/linkpred_2022_2023 [--beta 0.05] [--length 3] [--top 100 --top 1000]
+//            [--save-pairs]
+//
+// Every non-edge (u, v) of --graph at distance 2 whose endpoints both appear in
+// --next is a candidate, positive when (u, v) is an edge of --next. Scores,
+// all on the unweighted graph:
+//   common_neighbours  |N(u) & N(v)|
+//   adamic_adar        sum over common neighbours w of 1 / ln k_w
+//   resource_alloc     sum over common neighbours w of 1 / k_w
+//   katz               sum_{l=2..length} beta^l (A^l)_uv, truncated Katz
+//
+// Writes <out>_summary.csv with ROC-AUC, average precision and precision at
+// each --top k (default 100, 1000, 10000) per score, and with --save-pairs
+// every candidate to <out>_pairs.csv. New edges of --next that are further
+// than 2 hops apart in --graph are out of reach of the candidates; their
+// share is reported.
+//
+// Roots are processed in parallel. Each keeps bitsets of its neighbourhood
+// and of the 2-hop candidates found so far; the common-neighbour scores
+// accumulate over the wedges u - w - v, and path counts for Katz come from
+// sparse products over the nodes the walk has reached.
+
+#include "bitset.h"
+#include "cli.h"
+#include "metrics.h"
+#include "netio.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace cne;
+
+namespace {
+
+enum Score { CommonNeighbours, AdamicAdar, ResourceAllocation, Katz, Scores };
+const char* const score_names[Scores] = {"common_neighbours", "adamic_adar", "resource_alloc", "katz"};
+
+struct Candidate {
+    uint32_t v;
+    bool positive;
+    double score[Scores];
+};
+
+// Per-thread scratch for one root at a time
+struct Scorer {
+    Scorer(const Csr& graph, size_t length, double beta)
+        : g(graph), length(length), beta(beta), neighbour(graph.rows), seen(graph.rows), later(graph.rows, 0),
+          paths(graph.rows, 0.0), next_paths(graph.rows, 0.0), katz(graph.rows, 0.0),
+          partial(graph.rows * (Scores - 1), 0.0) {}
+
+    const Csr& g;
+    size_t length;
+    double beta;
+    Bitset neighbour, seen;
+    std::vector<char> later;  // neighbours of the root in the next year
+    std::vector<double> paths, next_paths, katz, partial;
+    std::vector<uint32_t> reached, next_reached, found, touched;  // touched: katz != 0
+
+    void root(uint32_t u, const std::vector<std::vector<uint32_t>>& next, const std::vector<char>& present,
+              std::vector<Candidate>& out) {
+        found.clear();
+        for (uint64_t e = g.offsets[u]; e < g.offsets[u + 1]; ++e) neighbour.set(g.indices[e]);
+        neighbour.set(u);
+        // Wedges u - w - v with v > u and not adjacent: the candidates
+        for (uint64_t e = g.offsets[u]; e < g.offsets[u + 1]; ++e) {
+            uint32_t w = g.indices[e];
+            double k = double(g.degree(w));
+            for (uint64_t f = g.offsets[w]; f < g.offsets[w + 1]; ++f) {
+                uint32_t v = g.indices[f];
+                if (v <= u || neighbour.test(v) || !present[v]) continue;
+                if (!seen.test(v)) {
+                    seen.set(v);
+                    found.push_back(v);
+                }
+                double* s = &partial[size_t(v) * (Scores - 1)];
+                s[CommonNeighbours] += 1;
+                s[AdamicAdar] += k > 1 ? 1 / std::log(k) : 0.0;
+                s[ResourceAllocation] += 1 / k;
+            }
+        }
+        if (found.empty()) {
+            clear(u);
+            return;
+        }
+        walk(u);
+        for (uint32_t v : next[u]) later[v] = 1;
+        std::sort(found.begin(), found.end());
+        for (uint32_t v : found) {
+            double* s = &partial[size_t(v) * (Scores - 1)];
+            out.push_back({v, later[v] != 0, {s[0], s[1], s[2], katz[v]}});
+            std::fill(s, s + Scores - 1, 0.0);
+            seen.clear(v);
+        }
+        for (uint32_t v : next[u]) later[v] = 0;
+        clear(u);
+    }
+
+    // katz[v] = sum_{l=2..length} beta^l (A^l)_uv over the nodes reached
+    void walk(uint32_t u) {
+        reached.assign(1, u);
+        paths[u] = 1;
+        double factor = 1;
+        for (size_t l = 1; l <= length; ++l) {
+            factor *= beta;
+            next_reached.clear();
+            for (uint32_t x : reached) {
+                for (uint64_t e = g.offsets[x]; e < g.offsets[x + 1]; ++e) {
+                    uint32_t y = g.indices[e];
+                    if (next_paths[y] == 0) next_reached.push_back(y);
+                    next_paths[y] += paths[x];
+                }
+                paths[x] = 0;
+            }
+            if (l >= 2)
+                for (uint32_t y : next_reached) katz[y] += factor * next_paths[y];
+            reached.swap(next_reached);
+            paths.swap(next_paths);
+            for (uint32_t y : reached) touched.push_back(y);
+        }
+        for (uint32_t x : reached) paths[x] = 0;
+    }
+
+    void clear(uint32_t u) {
+        for (uint64_t e = g.offsets[u]; e < g.offsets[u + 1]; ++e) neighbour.clear(g.indices[e]);
+        neighbour.clear(u);
+        for (uint32_t y : touched) katz[y] = 0;
+        touched.clear();
+    }
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    try {
+        Args args(argc, argv);
+        Csr g = load_csr(args.get("graph"));
+        Csr h = load_csr(args.get("next"));
+        if (g.rows != g.cols || h.rows != h.cols) throw std::runtime_error("graphs must be square");
+        size_t n = g.rows;
+        size_t length = args.integer("length", 3);
+        double beta = args.number("beta", 0.05);
+        if (length < 2) throw std::runtime_error("--length must be at least 2");
+        std::string out = args.get("out");
+        std::cout << "Graph: " << n << " nodes, " << g.nnz() / 2 << " edges; next: " << h.rows << " nodes, "
+                  << h.nnz() / 2 << " edges" << std::endl;
+
+        // Next year's adjacency in this year's node ids
+        std::vector<int64_t> to_g(h.rows);
+        std::vector<char> present(n, 0);
+        for (size_t v = 0; v < h.rows; ++v)
+            if ((to_g[v] = g.row_labels.find(h.row_labels[v])) >= 0) present[to_g[v]] = 1;
+        std::vector<std::vector<uint32_t>> next(n);
+        for (size_t v = 0; v < h.rows; ++v)
+            if (to_g[v] >= 0)
+                for (uint64_t e = h.offsets[v]; e < h.offsets[v + 1]; ++e)
+                    if (to_g[h.indices[e]] >= 0) next[to_g[v]].push_back(uint32_t(to_g[h.indices[e]]));
+
+        std::vector<std::vector<Candidate>> rows(n);
+#pragma omp parallel
+        {
+            Scorer scorer(g, length, beta);
+#pragma omp for schedule(dynamic, 16)
+            for (size_t u = 0; u < n; ++u)
+                if (present[u]) scorer.root(uint32_t(u), next, present, rows[u]);
+        }
+
+        // New edges of the next year between nodes of both, and how many the
+        // candidates cover
+        size_t added = 0, covered = 0, candidates = 0;
+        for (size_t u = 0; u < n; ++u) {
+            candidates += rows[u].size();
+            for (const auto& c : rows[u]) covered += c.positive;
+            for (uint32_t v : next[u]) {
+                if (v <= u) continue;
+                const uint32_t* begin = g.indices.data() + g.offsets[u];
+                const uint32_t* end = g.indices.data() + g.offsets[u + 1];
+                added += std::find(begin, end, v) == end;
+            }
+        }
+        std::cout << candidates << " distance-2 candidates; " << covered << " of " << added
+                  << " new edges are among them" << std::endl;
+
+        if (args.has("save-pairs")) {
+            std::ofstream pairs(out + "_pairs.csv");
+            pairs << "source,target";
+            for (const char* name : score_names) pairs << ',' << name;
+            pairs << ",appeared\n";
+            pairs.precision(10);
+            for (size_t u = 0; u < n; ++u)
+                for (const auto& c : rows[u]) {
+                    pairs << g.row_labels[u] << ',' << g.row_labels[c.v];
+                    for (double s : c.score) pairs << ',' << s;
+                    pairs << ',' << int(c.positive) << '\n';
+                }
+            if (!pairs) throw std::runtime_error(out + "_pairs.csv: write failed");
+        }
+
+        std::vector<size_t> ks;
+        for (const auto& k : args.all("top")) ks.push_back(std::stoul(k));
+        if (ks.empty()) ks = {100, 1000, 10000};
+        std::ofstream summary(out + "_summary.csv");
+        summary.precision(10);
+        summary << "score,candidates,positives,roc_auc,average_precision";
+        for (size_t k : ks) summary << ",precision_at_" << k;
+        summary << ",new_edges,new_edges_at_distance_2\n";
+        std::vector<Prediction> predictions(candidates);
+        for (int s = 0; s < Scores; ++s) {
+            size_t i = 0;
+            for (size_t u = 0; u < n; ++u)
+                for (const auto& c : rows[u]) predictions[i++] = {c.score[s], c.positive};
+            sort_by_score(predictions);
+            RankingSummary r = summarise_ranking(predictions);
+            std::vector<double> precision = precision_at(predictions, ks);
+            summary << score_names[s] << ',' << candidates << ',' << r.positives << ',' << r.auc << ','
+                    << r.average_precision;
+            for (double p : precision) summary << ',' << p;
+            summary << ',' << added << ',' << covered << '\n';
+            std::cout << score_names[s] << ": ROC-AUC " << r.auc << ", average precision " << r.average_precision
+                      << ", precision@" << ks[0] << " " << precision[0] << std::endl;
+        }
+        if (!summary) throw std::runtime_error(out + "_summary.csv: write failed");
+        std::cout << "Summary saved to " << out << "_summary.csv" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,84 @@
+#include "filtering.h"
+
+#include "linalg.h"
+
+#include <cmath>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace cne {
+
+namespace {
+
+// Inverts every block in parallel; blocks are small (4x4 and 3x3 for TMFG).
+std::vector<std::vector<double>> invert_blocks(const Matrix& cov, const std::vector<std::vector<uint32_t>>& sets) {
+    std::vector<std::vector<double>> inverses(sets.size());
+    bool failed = false;
+#pragma omp parallel for schedule(static)
+    for (size_t s = 0; s < sets.size(); ++s) {
+        const auto& ids = sets[s];
+        size_t k = ids.size();
+        std::vector<double> block(k * k);
+        for (size_t a = 0; a < k; ++a)
+            for (size_t b = 0; b < k; ++b) block[a * k + b] = cov.at(ids[a], ids[b]);
+        if (!invert_spd(block.data(), k)) {
+#pragma omp atomic write
+            failed = true;
+        }
+        inverses[s] = std::move(block);
+    }
+    if (failed) throw std::runtime_error("logo: a clique covariance block is not positive definite");
+    return inverses;
+}
+
+}  // namespace
+
+Csr logo(const Matrix& cov, const CliqueForest& forest) {
+    size_t n = cov.rows;
+    if (cov.cols != n) throw std::runtime_error("logo: covariance must be square");
+
+    std::vector<double> diagonal(n, 0.0);
+    std::unordered_map<uint64_t, double> off;
+    off.reserve(forest.edges.keys.size() * 2);
+    auto accumulate = [&](const std::vector<std::vector<uint32_t>>& sets, double sign) {
+        auto inverses = invert_blocks(cov, sets);
+        for (size_t s = 0; s < sets.size(); ++s) {
+            const auto& ids = sets[s];
+            size_t k = ids.size();
+            for (size_t a = 0; a < k; ++a) {
+                diagonal[ids[a]] += sign * inverses[s][a * k + a];
+                for (size_t b = a + 1; b < k; ++b) off[edge_key(ids[a], ids[b])] += sign * inverses[s][a * k + b];
+            }
+        }
+    };
+    accumulate(forest.cliques, 1.0);
+    accumulate(forest.separators, -1.0);
+
+    EdgeList entries;
+    for (uint64_t key : forest.edges.keys) {
+        auto it = off.find(key);
+        entries.keys.push_back(key);
+        entries.weights.push_back(it == off.end() ? 0.0 : it->second);
+    }
+    return csr_from_edges(cov.row_labels, entries, &diagonal);
+}
+
+Csr partial_correlations(const Csr& precision) {
+    std::vector<double> diagonal(precision.rows, 0.0);
+    for (uint64_t u = 0; u < precision.rows; ++u)
+        for (uint64_t e = precision.offsets[u]; e < precision.offsets[u + 1]; ++e)
+            if (precision.indices[e] == u) diagonal[u] = precision.values[e];
+
+    EdgeList entries;
+    for (uint64_t u = 0; u < precision.rows; ++u)
+        for (uint64_t e = precision.offsets[u]; e < precision.offsets[u + 1]; ++e) {
+            uint32_t v = precision.indices[e];
+            if (v <= u) continue;
+            double d = diagonal[u] * diagonal[v];
+            entries.keys.push_back(edge_key(u, v));
+            entries.weights.push_back(d > 0 ? -precision.values[e] / std::sqrt(d) : 0.0);
+        }
+    return csr_from_edges(precision.row_labels, entries);
+}
+
+}  // namespace cne
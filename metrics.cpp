@@ -0,0 +1,87 @@
+#include "metrics.h"
+
+#include "parallel.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace cne {
+
+void sort_by_score(std::vector<Prediction>& items) {
+    auto higher = [](const Prediction& a, const Prediction& b) { return a.score > b.score; };
+    size_t chunks = size_t(thread_count());
+    if (chunks < 2 || items.size() < (size_t(1) << 16)) {
+        std::sort(items.begin(), items.end(), higher);
+        return;
+    }
+    std::vector<size_t> bounds(chunks + 1);
+    for (size_t i = 0; i <= chunks; ++i) bounds[i] = items.size() * i / chunks;
+    auto at = [&](size_t i) { return items.begin() + bounds[std::min(i, chunks)]; };
+#pragma omp parallel for schedule(static, 1)
+    for (size_t i = 0; i < chunks; ++i) std::sort(at(i), at(i + 1), higher);
+    for (size_t width = 1; width < chunks; width *= 2) {
+#pragma omp parallel for schedule(dynamic, 1)
+        for (size_t i = 0; i < chunks; i += 2 * width)
+            if (i + width < chunks) std::inplace_merge(at(i), at(i + width), at(i + 2 * width), higher);
+    }
+}
+
+RankingSummary summarise_ranking(const std::vector<Prediction>& sorted) {
+    RankingSummary s;
+    for (const auto& p : sorted) (p.positive ? s.positives : s.negatives)++;
+    if (!s.positives || !s.negatives) return s;
+    // Walk groups of tied scores from the top; each positive beats every
+    // negative below its group and half of those inside it
+    double wins = 0, precision_sum = 0;
+    size_t negatives_above = 0, positives_seen = 0;
+    for (size_t i = 0; i < sorted.size();) {
+        size_t j = i, pos = 0;
+        while (j < sorted.size() && sorted[j].score == sorted[i].score) pos += sorted[j++].positive;
+        size_t neg = j - i - pos;
+        wins += pos * (double(s.negatives - negatives_above - neg) + 0.5 * neg);
+        // Within a tie group, precision is that of the whole group
+        positives_seen += pos;
+        precision_sum += pos * double(positives_seen) / j;
+        negatives_above += neg;
+        i = j;
+    }
+    s.auc = wins / (double(s.positives) * s.negatives);
+    s.average_precision = precision_sum / s.positives;
+    return s;
+}
+
+std::vector<double> precision_at(const std::vector<Prediction>& sorted, const std::vector<size_t>& ks) {
+    std::vector<double> result;
+    for (size_t k : ks) {
+        k = std::min(k, sorted.size());
+        double hits = 0;
+        for (size_t i = 0; i < k;) {
+            size_t j = i, pos = 0;
+            while (j < sorted.size() && sorted[j].score == sorted[i].score) pos += sorted[j++].positive;
+            hits += j <= k ? pos : double(pos) * (k - i) / (j - i);
+            i = j;
+        }
+        result.push_back(k ? hits / k : 0.0);
+    }
+    return result;
+}
+
+std::vector<CalibrationBin> calibration(const std::vector<Prediction>& sorted, size_t bins) {
+    if (bins == 0) throw std::runtime_error("calibration needs at least one bin");
+    std::vector<CalibrationBin> result;
+    for (size_t b = 0; b < bins; ++b) {
+        size_t begin = sorted.size() * b / bins, end = sorted.size() * (b + 1) / bins;
+        if (begin == end) continue;
+        CalibrationBin bin{sorted[end - 1].score, sorted[begin].score, 0.0, 0.0, end - begin};
+        for (size_t i = begin; i < end; ++i) {
+            bin.mean_score += sorted[i].score;
+            bin.rate += sorted[i].positive;
+        }
+        bin.mean_score /= bin.count;
+        bin.rate /= bin.count;
+        result.push_back(bin);
+    }
+    return result;
+}
+
+}  // namespace cne
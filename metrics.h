@@ -0,0 +1,43 @@
+#pragma once
+
+// Ranking metrics for scored binary outcomes (e.g. density against whether an
+// activity appears later), over millions of candidates.
+
+#include <cstddef>
+#include <vector>
+
+namespace cne {
+
+struct Prediction {
+    double score;
+    bool positive;
+};
+
+// Sorts by decreasing score: chunks are sorted in parallel, then merged
+// pairwise in log2(threads) parallel rounds.
+void sort_by_score(std::vector<Prediction>& items);
+
+struct RankingSummary {
+    size_t positives = 0, negatives = 0;
+    double auc = 0.5;              // ROC-AUC, tied scores count one half
+    double average_precision = 0;  // mean precision at each positive
+};
+
+// `sorted` as left by sort_by_score
+RankingSummary summarise_ranking(const std::vector<Prediction>& sorted);
+
+// Fraction of positives among the first k of `sorted`, for each k. When k
+// cuts through a group of tied scores, that group contributes its positive
+// rate (the expectation under random tie-breaking), so the result does not
+// depend on how the sort ordered ties.
+std::vector<double> precision_at(const std::vector<Prediction>& sorted, const std::vector<size_t>& ks);
+
+struct CalibrationBin {
+    double min_score, max_score, mean_score, rate;
+    size_t count;
+};
+
+// Equal-count bins along `sorted`, from the highest scores down
+std::vector<CalibrationBin> calibration(const std::vector<Prediction>& sorted, size_t bins);
+
+}  // namespace cne
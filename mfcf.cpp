@@ -0,0 +1,135 @@
+#include "filtering.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace cne {
+
+namespace {
+
+struct Face {
+    std::vector<uint32_t> nodes;   // the clique, sorted
+    std::vector<uint32_t> attach;  // where `best` would attach
+    uint32_t best = 0;
+    double gain = -std::numeric_limits<double>::infinity();
+};
+
+}  // namespace
+
+CliqueForest mfcf(const Matrix& w, const MfcfParams& params) {
+    size_t n = w.rows, k = params.max_clique;
+    if (w.cols != n) throw std::runtime_error("mfcf: weight matrix must be square");
+    if (k < 2) throw std::runtime_error("mfcf: max clique size must be at least 2");
+
+    std::vector<double> strength(n, 0.0);
+#pragma omp parallel for schedule(static)
+    for (size_t i = 0; i < n; ++i)
+        for (size_t j = 0; j < n; ++j)
+            if (i != j && w.at(i, j) > 0) strength[i] += w.at(i, j);
+
+    CliqueForest out;
+    std::vector<char> inserted(n, 0);
+    std::vector<std::pair<uint32_t, uint32_t>> edges;
+    std::vector<Face> faces;  // one per clique, same index
+
+    // Best vertex for a clique: it attaches to the clique's nodes it has an
+    // edge of at least `threshold` to, the heaviest k - 1 of them when the
+    // clique is complete, and gains their sum. Attaching to the whole of a
+    // clique below max size grows it; any other subset is a separator.
+    auto rescore = [&](Face& f) {
+        f.gain = -std::numeric_limits<double>::infinity();
+        f.attach.clear();
+        size_t limit = std::min(f.nodes.size(), k - 1);
+        std::vector<std::pair<double, uint32_t>> qualified;
+        for (uint32_t u = 0; u < n; ++u) {
+            if (inserted[u]) continue;
+            qualified.clear();
+            for (uint32_t x : f.nodes)
+                if (w.at(x, u) >= params.threshold) qualified.emplace_back(w.at(x, u), x);
+            if (qualified.empty()) continue;
+            if (qualified.size() > limit) {
+                std::partial_sort(qualified.begin(), qualified.begin() + limit, qualified.end(),
+                                  [](const auto& a, const auto& b) { return a.first > b.first; });
+                qualified.resize(limit);
+            }
+            double s = 0;
+            for (const auto& q : qualified) s += q.first;
+            if (s > f.gain) {
+                f.gain = s;
+                f.best = u;
+                f.attach.clear();
+                for (const auto& q : qualified) f.attach.push_back(q.second);
+            }
+        }
+        std::sort(f.attach.begin(), f.attach.end());
+    };
+
+    auto start_component = [&](std::vector<size_t>& fresh) {
+        uint32_t v = 0;
+        double s = -std::numeric_limits<double>::infinity();
+        for (uint32_t u = 0; u < n; ++u)
+            if (!inserted[u] && strength[u] > s) s = strength[u], v = u;
+        inserted[v] = 1;
+        out.cliques.push_back({v});
+        fresh.push_back(faces.size());
+        faces.push_back({{v}, {}, 0, 0});
+        return v;
+    };
+
+    std::vector<size_t> fresh;
+    uint32_t v = start_component(fresh);
+    for (size_t step = 1; step < n; ++step) {
+        // Faces that wanted the vertex just placed, and new faces, look again
+        for (size_t f = 0; f < faces.size(); ++f)
+            if (faces[f].best == v) fresh.push_back(f);
+        std::sort(fresh.begin(), fresh.end());
+        fresh.erase(std::unique(fresh.begin(), fresh.end()), fresh.end());
+#pragma omp parallel for schedule(dynamic) if (fresh.size() > 8)
+        for (size_t s = 0; s < fresh.size(); ++s) rescore(faces[fresh[s]]);
+        fresh.clear();
+
+        // A new component starts only when no vertex has a qualifying edge
+        // into any clique
+        int64_t f = -1;
+        for (size_t g = 0; g < faces.size(); ++g) {
+            if (faces[g].attach.empty()) continue;
+            if (f < 0 || faces[g].gain > faces[f].gain) f = g;
+        }
+        if (f < 0) {
+            v = start_component(fresh);
+            continue;
+        }
+
+        v = faces[f].best;
+        inserted[v] = 1;
+        std::vector<uint32_t> attach = faces[f].attach;
+        for (uint32_t u : attach) edges.emplace_back(u, v);
+
+        if (attach.size() == faces[f].nodes.size()) {
+            // Only possible below max size: the clique grows
+            out.cliques[f].push_back(v);
+            faces[f].nodes.insert(std::upper_bound(faces[f].nodes.begin(), faces[f].nodes.end(), v), v);
+            fresh.push_back(f);
+        } else {
+            out.separators.push_back(attach);
+            std::vector<uint32_t> clique = attach;
+            clique.insert(std::upper_bound(clique.begin(), clique.end(), v), v);
+            out.cliques.push_back(clique);
+            fresh.push_back(faces.size());
+            faces.push_back({clique, {}, 0, 0});
+        }
+    }
+
+    std::vector<std::pair<uint64_t, double>> keyed;
+    for (const auto& [a, b] : edges) keyed.emplace_back(edge_key(a, b), w.at(a, b));
+    std::sort(keyed.begin(), keyed.end());
+    for (const auto& [key, weight] : keyed) {
+        out.edges.keys.push_back(key);
+        out.edges.weights.push_back(weight);
+        out.total_weight += weight;
+    }
+    return out;
+}
+
+}  // namespace cne
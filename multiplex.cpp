@@ -0,0 +1,161 @@
+#include "multiplex.h"
+
+#include "edges.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace cne {
+
+Multiplex align_layers(const std::vector<std::string>& names, const std::vector<Csr>& graphs) {
+    if (names.size() != graphs.size()) throw std::runtime_error("align_layers: one name per graph");
+    Multiplex m;
+    m.names = names;
+    std::vector<EdgeList> edges;
+    for (const auto& g : graphs) {
+        if (g.rows != g.cols) throw std::runtime_error("layer graphs must be square");
+        edges.push_back(edge_list(g, remap_labels(g.row_labels, m.nodes)));
+    }
+    for (const auto& e : edges) m.layers.push_back(csr_from_edges(m.nodes, e));
+    return m;
+}
+
+LayerOverlap layer_overlap(const Multiplex& m) {
+    size_t n = m.size(), L = m.layers.size();
+    LayerOverlap out;
+    out.common.assign(L * L, 0);
+    for (const auto& g : m.layers) out.edges.push_back(g.nnz() / 2);
+#pragma omp parallel
+    {
+        std::vector<uint64_t> common(L * L, 0);
+#pragma omp for schedule(dynamic, 256)
+        for (size_t u = 0; u < n; ++u)
+            for (size_t a = 0; a < L; ++a)
+                for (size_t b = a + 1; b < L; ++b) {
+                    // Sorted rows: count shared neighbours v > u once per edge
+                    const Csr &ga = m.layers[a], &gb = m.layers[b];
+                    uint64_t i = ga.offsets[u], i1 = ga.offsets[u + 1], j = gb.offsets[u], j1 = gb.offsets[u + 1];
+                    while (i < i1 && ga.indices[i] <= u) ++i;
+                    while (j < j1 && gb.indices[j] <= u) ++j;
+                    while (i < i1 && j < j1) {
+                        if (ga.indices[i] < gb.indices[j]) ++i;
+                        else if (gb.indices[j] < ga.indices[i]) ++j;
+                        else ++common[a * L + b], ++i, ++j;
+                    }
+                }
+#pragma omp critical
+        for (size_t k = 0; k < L * L; ++k) out.common[k] += common[k];
+    }
+    for (size_t a = 0; a < L; ++a) {
+        out.common[a * L + a] = out.edges[a];
+        for (size_t b = a + 1; b < L; ++b) out.common[b * L + a] = out.common[a * L + b];
+    }
+    return out;
+}
+
+MultiplexDegrees multiplex_degrees(const Multiplex& m) {
+    size_t n = m.size(), L = m.layers.size();
+    MultiplexDegrees out;
+    out.degree.assign(n * L, 0);
+    out.overlapping.assign(n, 0);
+    out.aggregate.assign(n, 0);
+    out.participation.assign(n, 0.0);
+#pragma omp parallel
+    {
+        std::vector<uint64_t> pos(L);
+#pragma omp for schedule(dynamic, 256)
+        for (size_t u = 0; u < n; ++u) {
+            uint32_t o = 0;
+            for (size_t a = 0; a < L; ++a) {
+                out.degree[u * L + a] = uint32_t(m.layers[a].degree(u));
+                o += out.degree[u * L + a];
+                pos[a] = m.layers[a].offsets[u];
+            }
+            out.overlapping[u] = o;
+            if (!o) continue;
+            double sq = 0;
+            for (size_t a = 0; a < L; ++a) sq += double(out.degree[u * L + a]) * out.degree[u * L + a];
+            out.participation[u] = L > 1 ? double(L) / (L - 1) * (1 - sq / (double(o) * o)) : 0.0;
+
+            // k-way merge of the sorted rows for the distinct neighbours
+            uint32_t distinct = 0;
+            for (;;) {
+                uint32_t v = UINT32_MAX;
+                for (size_t a = 0; a < L; ++a)
+                    if (pos[a] < m.layers[a].offsets[u + 1]) v = std::min(v, m.layers[a].indices[pos[a]]);
+                if (v == UINT32_MAX) break;
+                for (size_t a = 0; a < L; ++a)
+                    if (pos[a] < m.layers[a].offsets[u + 1] && m.layers[a].indices[pos[a]] == v) ++pos[a];
+                ++distinct;
+            }
+            out.aggregate[u] = distinct;
+        }
+    }
+    return out;
+}
+
+MultiplexPageRank multiplex_pagerank(const Multiplex& m, const PageRankParams& params) {
+    size_t n = m.size(), L = m.layers.size(), states = n * L;
+    if (L < 2) throw std::runtime_error("multiplex PageRank needs at least two layers");
+    if (!(params.damping >= 0 && params.damping < 1)) throw std::runtime_error("damping must be in [0, 1)");
+    if (!(params.switch_rate >= 0 && params.switch_rate <= 1)) throw std::runtime_error("switch rate must be in [0, 1]");
+    if (params.weighted && !params.absolute)
+        for (const auto& g : m.layers)
+            for (double w : g.values)
+                if (w < 0) throw std::runtime_error("negative edge weight; use absolute or unweighted transitions");
+    auto weight = [&](double w) { return !params.weighted ? 1.0 : params.absolute ? std::fabs(w) : w; };
+
+    // Per state: probability per unit of edge weight of an intra-layer step,
+    // and of each jump to one of the other L - 1 replicas
+    std::vector<double> step(states, 0.0), jump(states);
+#pragma omp parallel for schedule(dynamic, 256)
+    for (size_t u = 0; u < n; ++u)
+        for (size_t a = 0; a < L; ++a) {
+            const Csr& g = m.layers[a];
+            double s = 0;
+            for (uint64_t e = g.offsets[u]; e < g.offsets[u + 1]; ++e) s += weight(g.values[e]);
+            if (s > 0) step[u * L + a] = (1 - params.switch_rate) / s;
+            jump[u * L + a] = (s > 0 ? params.switch_rate : 1.0) / (L - 1);
+        }
+
+    MultiplexPageRank out;
+    std::vector<double> x(states, 1.0 / states), next(states);
+    double teleport = (1 - params.damping) / states;
+    for (out.iterations = 1; out.iterations <= params.max_iterations; ++out.iterations) {
+        // Pull over the symmetric layers, so each state is written by one thread
+        double total = 0;
+#pragma omp parallel for schedule(dynamic, 256) reduction(+ : total)
+        for (size_t v = 0; v < n; ++v) {
+            double replicas = 0;
+            for (size_t a = 0; a < L; ++a) replicas += x[v * L + a] * jump[v * L + a];
+            for (size_t b = 0; b < L; ++b) {
+                const Csr& g = m.layers[b];
+                double s = replicas - x[v * L + b] * jump[v * L + b];
+                for (uint64_t e = g.offsets[v]; e < g.offsets[v + 1]; ++e) {
+                    size_t u = g.indices[e];
+                    s += x[u * L + b] * step[u * L + b] * weight(g.values[e]);
+                }
+                next[v * L + b] = teleport + params.damping * s;
+                total += next[v * L + b];
+            }
+        }
+        // Renormalise against rounding drift, then measure the change
+        double diff = 0;
+        for (size_t k = 0; k < states; ++k) {
+            next[k] /= total;
+            diff += std::fabs(next[k] - x[k]);
+        }
+        x.swap(next);
+        out.residual = diff;
+        if (diff < params.tolerance) break;
+    }
+    out.iterations = std::min(out.iterations, params.max_iterations);
+    out.node.assign(n, 0.0);
+    for (size_t u = 0; u < n; ++u)
+        for (size_t a = 0; a < L; ++a) out.node[u] += x[u * L + a];
+    out.state = std::move(x);
+    return out;
+}
+
+}  // namespace cne
@@ -0,0 +1,78 @@
+#pragma once
+
+// Multilayer networks: several graphs over the same kind of node (e.g. the
+// location networks filtered from CNAE industry and from CBO occupation
+// profiles) aligned on one set of interned ids, so that every per-node
+// statistic is a single parallel pass over the rows of all layers.
+
+#include "netio.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace cne {
+
+struct Multiplex {
+    Labels nodes;
+    std::vector<std::string> names;
+    std::vector<Csr> layers;  // symmetric, nodes.size() rows each, rows sorted, no diagonal
+
+    size_t size() const { return nodes.size(); }
+};
+
+// Aligns symmetric graphs on the union of their node labels; a node missing
+// from a graph is isolated in that layer. Self loops are dropped.
+Multiplex align_layers(const std::vector<std::string>& names, const std::vector<Csr>& graphs);
+
+// Edges per layer and edges shared by each pair of layers (L x L row-major,
+// the diagonal holding the layer's own count).
+struct LayerOverlap {
+    std::vector<uint64_t> edges;
+    std::vector<uint64_t> common;
+
+    double jaccard(size_t a, size_t b) const {
+        size_t L = edges.size();
+        uint64_t all = edges[a] + edges[b] - common[a * L + b];
+        return all ? double(common[a * L + b]) / all : 0.0;
+    }
+};
+LayerOverlap layer_overlap(const Multiplex& m);
+
+// Degree of every node in every layer (n x L row-major), the overlapping
+// degree (their sum), the aggregate degree (distinct neighbours over all
+// layers) and the participation coefficient of Battiston et al. (2014),
+// P = L / (L - 1) (1 - sum_a (k_a / o)^2): 0 for a node whose edges all lie
+// in one layer, 1 when they are spread evenly.
+struct MultiplexDegrees {
+    std::vector<uint32_t> degree;
+    std::vector<uint32_t> overlapping, aggregate;
+    std::vector<double> participation;
+};
+MultiplexDegrees multiplex_degrees(const Multiplex& m);
+
+// PageRank of a random walker on the supra-graph with one state per (node,
+// layer). At each step it teleports to a uniform state with probability
+// 1 - damping; otherwise it changes layer (to the same node in another layer,
+// uniformly) with probability `switch_rate`, or always when the node is
+// isolated in its current layer, and follows an edge of the current layer
+// otherwise. Transitions follow edge weights unless `weighted` is false, their
+// magnitudes with `absolute` (for layers filtered from signed correlations);
+// any other negative weight is an error.
+struct PageRankParams {
+    double damping = 0.85;
+    double switch_rate = 0.5;
+    bool weighted = true;
+    bool absolute = false;
+    size_t max_iterations = 200;
+    double tolerance = 1e-10;  // on the L1 change of the state vector
+};
+struct MultiplexPageRank {
+    std::vector<double> state;  // n x L row-major, sums to 1
+    std::vector<double> node;   // summed over layers
+    size_t iterations = 0;
+    double residual = 0;
+};
+MultiplexPageRank multiplex_pagerank(const Multiplex& m, const PageRankParams& params = {});
+
+}  // namespace cne
@@ -0,0 +1,202 @@
+#include "netio.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace cne {
+
+namespace {
+
+const char kMatrixMagic[8] = {'C', 'N', 'E', 'M', 'A', 'T', '1', '\0'};
+const char kCsrMagic[8] = {'C', 'N', 'E', 'C', 'S', 'R', '1', '\0'};
+const char kTriangleMagic[8] = {'C', 'N', 'E', 'T', 'R', 'I', '1', '\0'};
+
+struct Header {
+    char magic[8];
+    uint64_t rows;
+    uint64_t cols;
+    uint64_t nnz;
+    uint64_t label_bytes;
+    uint64_t reserved;
+};
+static_assert(sizeof(Header) == 48, "header layout");
+
+uint64_t pad8(uint64_t n) { return (n + 7) & ~uint64_t(7); }
+
+// Returns the offset of the payload that follows the label block.
+uint64_t read_header(const MappedFile& file, const char* magic, Header& h,
+                     Labels& row_labels, Labels& col_labels, const std::string& path) {
+    if (file.size() < sizeof(Header))
+        throw std::runtime_error(path + ": file too small");
+    std::memcpy(&h, file.data(), sizeof(Header));
+    if (std::memcmp(h.magic, magic, 8) != 0)
+        throw std::runtime_error(path + ": unexpected file type");
+    uint64_t offset = sizeof(Header);
+    if (offset + h.label_bytes > file.size())
+        throw std::runtime_error(path + ": truncated label block");
+
+    const char* p = file.data() + offset;
+    const char* end = p + h.label_bytes;
+    for (uint64_t k = 0; k < h.rows + h.cols; ++k) {
+        const char* nl = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        if (!nl) throw std::runtime_error(path + ": malformed label block");
+        (k < h.rows ? row_labels : col_labels).intern(std::string(p, nl));
+        p = nl + 1;
+    }
+    if (row_labels.size() != h.rows || col_labels.size() != h.cols)
+        throw std::runtime_error(path + ": duplicate labels");
+    return offset + pad8(h.label_bytes);
+}
+
+void write_header(std::ofstream& out, const char* magic, uint64_t rows, uint64_t cols,
+                  uint64_t nnz, const Labels& row_labels, const Labels& col_labels) {
+    std::string block;
+    for (const auto& name : row_labels.names) block += name + '\n';
+    for (const auto& name : col_labels.names) block += name + '\n';
+
+    Header h{};
+    std::memcpy(h.magic, magic, 8);
+    h.rows = rows;
+    h.cols = cols;
+    h.nnz = nnz;
+    h.label_bytes = block.size();
+    block.resize(pad8(block.size()), '\0');
+    out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    out.write(block.data(), block.size());
+}
+
+template <typename T>
+void write_array(std::ofstream& out, const T* data, uint64_t n) {
+    out.write(reinterpret_cast<const char*>(data), n * sizeof(T));
+}
+
+}  // namespace
+
+MappedFile::MappedFile(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error(path + ": " + std::strerror(errno));
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error(path + ": " + std::strerror(errno));
+    }
+    size_ = st.st_size;
+    if (size_ > 0) {
+        void* p = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED | MAP_POPULATE, fd, 0);
+        if (p == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error(path + ": mmap failed");
+        }
+        data_ = static_cast<const char*>(p);
+    }
+    ::close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if (data_) ::munmap(const_cast<char*>(data_), size_);
+}
+
+uint32_t Labels::intern(const std::string& name) {
+    auto it = index.find(name);
+    if (it != index.end()) return it->second;
+    uint32_t id = names.size();
+    names.push_back(name);
+    index.emplace(name, id);
+    return id;
+}
+
+int64_t Labels::find(const std::string& name) const {
+    auto it = index.find(name);
+    return it == index.end() ? -1 : int64_t(it->second);
+}
+
+std::vector<uint32_t> remap_labels(const Labels& from, Labels& into) {
+    std::vector<uint32_t> remap(from.size());
+    for (size_t i = 0; i < from.size(); ++i) remap[i] = into.intern(from[i]);
+    return remap;
+}
+
+Matrix load_matrix(const std::string& path) {
+    auto file = std::make_shared<MappedFile>(path);
+    Header h;
+    Matrix m;
+    uint64_t offset = read_header(*file, kMatrixMagic, h, m.row_labels, m.col_labels, path);
+    m.rows = h.rows;
+    m.cols = h.cols;
+    if (offset + m.rows * m.cols * sizeof(double) > file->size())
+        throw std::runtime_error(path + ": truncated matrix");
+    auto* values = reinterpret_cast<const double*>(file->data() + offset);
+    m.values = Buffer<double>(file, values, m.rows * m.cols);
+    return m;
+}
+
+Csr load_csr(const std::string& path) {
+    auto file = std::make_shared<MappedFile>(path);
+    Header h;
+    Csr g;
+    uint64_t offset = read_header(*file, kCsrMagic, h, g.row_labels, g.col_labels, path);
+    g.rows = h.rows;
+    g.cols = h.cols;
+    uint64_t index_offset = offset + (g.rows + 1) * sizeof(uint64_t);
+    uint64_t value_offset = index_offset + pad8(h.nnz * sizeof(uint32_t));
+    if (value_offset + h.nnz * sizeof(double) > file->size())
+        throw std::runtime_error(path + ": truncated graph");
+    const char* base = file->data();
+    g.offsets = Buffer<uint64_t>(file, reinterpret_cast<const uint64_t*>(base + offset), g.rows + 1);
+    g.indices = Buffer<uint32_t>(file, reinterpret_cast<const uint32_t*>(base + index_offset), h.nnz);
+    g.values = Buffer<double>(file, reinterpret_cast<const double*>(base + value_offset), h.nnz);
+    if (g.offsets[g.rows] != h.nnz)
+        throw std::runtime_error(path + ": inconsistent offsets");
+    return g;
+}
+
+Triangle load_triangle(const std::string& path) {
+    auto file = std::make_shared<MappedFile>(path);
+    Header h;
+    Triangle t;
+    Labels col_labels;
+    uint64_t offset = read_header(*file, kTriangleMagic, h, t.labels, col_labels, path);
+    t.n = h.rows;
+    if (h.cols != h.rows || h.nnz != t.n * (t.n - (t.n > 0)) / 2)
+        throw std::runtime_error(path + ": inconsistent triangle size");
+    if (offset + h.nnz * sizeof(double) > file->size())
+        throw std::runtime_error(path + ": truncated triangle");
+    t.values = Buffer<double>(file, reinterpret_cast<const double*>(file->data() + offset), h.nnz);
+    return t;
+}
+
+void save_matrix(const std::string& path, const Matrix& m) {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) throw std::runtime_error(path + ": cannot open for writing");
+    write_header(out, kMatrixMagic, m.rows, m.cols, 0, m.row_labels, m.col_labels);
+    write_array(out, m.values.data(), m.rows * m.cols);
+    if (!out) throw std::runtime_error(path + ": write failed");
+}
+
+void save_csr(const std::string& path, const Csr& g) {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) throw std::runtime_error(path + ": cannot open for writing");
+    write_header(out, kCsrMagic, g.rows, g.cols, g.nnz(), g.row_labels, g.col_labels);
+    write_array(out, g.offsets.data(), g.rows + 1);
+    write_array(out, g.indices.data(), g.nnz());
+    static const char zeros[8] = {};
+    out.write(zeros, pad8(g.nnz() * sizeof(uint32_t)) - g.nnz() * sizeof(uint32_t));
+    write_array(out, g.values.data(), g.nnz());
+    if (!out) throw std::runtime_error(path + ": write failed");
+}
+
+void save_triangle(const std::string& path, const Triangle& t) {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) throw std::runtime_error(path + ": cannot open for writing");
+    write_header(out, kTriangleMagic, t.n, t.n, t.values.size(), t.labels, t.labels);
+    write_array(out, t.values.data(), t.values.size());
+    if (!out) throw std::runtime_error(path + ": write failed");
+}
+
+}  // namespace cne
@@ -0,0 +1,119 @@
+#pragma once
+
+// Binary matrix and graph files shared by the C++ tools.
+//
+// Every file starts with a 48-byte header followed by the row and column
+// labels (one per line, padded to 8 bytes) and then the payload:
+//   .mat  dense row-major doubles, rows x cols
+//   .csr  uint64 offsets[rows + 1], uint32 indices[nnz] (padded), double values[nnz]
+//   .tri  symmetric n x n matrix as its strict upper triangle, row-major doubles
+//         (0,1) (0,2) .. (0,n-1) (1,2) .. (n-2,n-1); rows = cols = n
+// export_bin.py writes these from the CSV/GraphML outputs of the Python scripts.
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace cne {
+
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+// Either owns its elements or points into a mapped file kept alive by `map_`.
+template <typename T>
+class Buffer {
+public:
+    Buffer() = default;
+    explicit Buffer(std::vector<T> values) : owned_(std::move(values)) {}
+    Buffer(std::shared_ptr<MappedFile> map, const T* ptr, size_t n)
+        : map_(std::move(map)), ptr_(ptr), size_(n) {}
+
+    const T* data() const { return map_ ? ptr_ : owned_.data(); }
+    size_t size() const { return map_ ? size_ : owned_.size(); }
+    const T& operator[](size_t i) const { return data()[i]; }
+    const T* begin() const { return data(); }
+    const T* end() const { return data() + size(); }
+
+private:
+    std::vector<T> owned_;
+    std::shared_ptr<MappedFile> map_;
+    const T* ptr_ = nullptr;
+    size_t size_ = 0;
+};
+
+struct Labels {
+    std::vector<std::string> names;
+    std::unordered_map<std::string, uint32_t> index;
+
+    uint32_t intern(const std::string& name);
+    int64_t find(const std::string& name) const;  // -1 when absent
+    size_t size() const { return names.size(); }
+    const std::string& operator[](size_t i) const { return names[i]; }
+};
+
+// Maps every label of `from` to its id in `into`, interning new labels.
+std::vector<uint32_t> remap_labels(const Labels& from, Labels& into);
+
+struct Matrix {
+    uint64_t rows = 0, cols = 0;
+    Labels row_labels, col_labels;
+    Buffer<double> values;
+
+    const double* row(uint64_t i) const { return values.data() + i * cols; }
+    double at(uint64_t i, uint64_t j) const { return values[i * cols + j]; }
+};
+
+// Compressed sparse rows. Undirected graphs are stored with both directions
+// and identical row/column labels.
+struct Csr {
+    uint64_t rows = 0, cols = 0;
+    Labels row_labels, col_labels;
+    Buffer<uint64_t> offsets;
+    Buffer<uint32_t> indices;
+    Buffer<double> values;
+
+    uint64_t nnz() const { return indices.size(); }
+    uint64_t degree(uint64_t i) const { return offsets[i + 1] - offsets[i]; }
+};
+
+// Symmetric matrix with zero diagonal, e.g. a dense proximity matrix, in half
+// the space of a .mat.
+struct Triangle {
+    uint64_t n = 0;
+    Labels labels;
+    Buffer<double> values;  // n (n - 1) / 2
+
+    static uint64_t row_offset(uint64_t i, uint64_t n) { return i * (2 * n - i - 1) / 2; }
+    // Entries (i, i+1) .. (i, n-1)
+    const double* row(uint64_t i) const { return values.data() + row_offset(i, n); }
+    double at(uint64_t i, uint64_t j) const {
+        if (i == j) return 0.0;
+        if (i > j) std::swap(i, j);
+        return row(i)[j - i - 1];
+    }
+};
+
+Matrix load_matrix(const std::string& path);  // memory mapped
+Csr load_csr(const std::string& path);        // memory mapped
+Triangle load_triangle(const std::string& path);  // memory mapped
+void save_matrix(const std::string& path, const Matrix& m);
+void save_csr(const std::string& path, const Csr& g);
+void save_triangle(const std::string& path, const Triangle& t);
+
+}  // namespace cne
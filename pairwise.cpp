@@ -0,0 +1,126 @@
+#include "pairwise.h"
+
+#include "netio.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace cne {
+
+namespace {
+
+constexpr size_t kTile = 32;    // rows per tile
+constexpr size_t kDepth = 512;  // columns per chunk: two tiles fit in L2
+
+template <bool L1>
+float reduce(const float* a, const float* b, size_t len) {
+    float s = 0;
+    if (L1) {
+#pragma omp simd reduction(+ : s)
+        for (size_t k = 0; k < len; ++k) s += std::fabs(a[k] - b[k]);
+    } else {
+#pragma omp simd reduction(+ : s)
+        for (size_t k = 0; k < len; ++k) s += a[k] * b[k];
+    }
+    return s;
+}
+
+template <bool L1>
+std::vector<double> all_pairs(const float* x, size_t n, size_t dim) {
+    std::vector<double> tri(n > 1 ? n * (n - 1) / 2 : 0, 0.0);
+    size_t tiles = (n + kTile - 1) / kTile;
+#pragma omp parallel
+    {
+        // Chunk sums are in float, the running totals across chunks in double
+        std::vector<double> acc(kTile * kTile);
+#pragma omp for schedule(dynamic, 1)
+        for (size_t ti = 0; ti < tiles; ++ti) {
+            size_t i0 = ti * kTile, i1 = std::min(n, i0 + kTile);
+            for (size_t tj = ti; tj < tiles; ++tj) {
+                size_t j0 = tj * kTile, j1 = std::min(n, j0 + kTile);
+                std::fill(acc.begin(), acc.end(), 0.0);
+                for (size_t k0 = 0; k0 < dim; k0 += kDepth) {
+                    size_t len = std::min(kDepth, dim - k0);
+                    for (size_t i = i0; i < i1; ++i) {
+                        const float* a = x + i * dim + k0;
+                        for (size_t j = std::max(j0, i + 1); j < j1; ++j)
+                            acc[(i - i0) * kTile + (j - j0)] += reduce<L1>(a, x + j * dim + k0, len);
+                    }
+                }
+                for (size_t i = i0; i < i1; ++i) {
+                    double* out = &tri[Triangle::row_offset(i, n)];
+                    for (size_t j = std::max(j0, i + 1); j < j1; ++j) out[j - i - 1] = acc[(i - i0) * kTile + (j - j0)];
+                }
+            }
+        }
+    }
+    return tri;
+}
+
+}  // namespace
+
+std::vector<double> pairwise_correlation(const double* x, const uint8_t* present, size_t n, size_t dim,
+                                         size_t min_overlap, std::vector<uint32_t>* overlap) {
+    constexpr size_t kRows = 16, kBlock = 256;
+    // Column-major copies with missing values zeroed, so that every masked
+    // sum is a plain product
+    std::vector<double> xt(dim * n, 0.0), mt(dim * n, 0.0);
+    for (size_t i = 0; i < n; ++i)
+        for (size_t k = 0; k < dim; ++k)
+            if (present[i * dim + k]) {
+                xt[k * n + i] = x[i * dim + k];
+                mt[k * n + i] = 1;
+            }
+    std::vector<double> corr(n * n, 0.0);
+    if (overlap) overlap->assign(n * n, 0);
+    for (size_t i = 0; i < n; ++i) corr[i * n + i] = 1;
+#pragma omp parallel
+    {
+        // count, sum x_i, sum x_j, sum x_i^2, sum x_j^2, sum x_i x_j over shared columns
+        std::vector<double> acc(6 * kBlock);
+        double *cnt = &acc[0], *si = &acc[kBlock], *sj = &acc[2 * kBlock], *sii = &acc[3 * kBlock],
+               *sjj = &acc[4 * kBlock], *sij = &acc[5 * kBlock];
+#pragma omp for schedule(dynamic, 1)
+        for (size_t i0 = 0; i0 < n; i0 += kRows) {
+            size_t i1 = std::min(n, i0 + kRows);
+            for (size_t j0 = i0 + 1; j0 < n; j0 += kBlock) {
+                size_t len = std::min(kBlock, n - j0);
+                for (size_t i = i0; i < i1; ++i) {
+                    std::fill(acc.begin(), acc.end(), 0.0);
+                    for (size_t k = 0; k < dim; ++k) {
+                        double xi = xt[k * n + i], mi = mt[k * n + i];
+                        if (mi == 0) continue;
+                        const double* xj = &xt[k * n + j0];
+                        const double* mj = &mt[k * n + j0];
+#pragma omp simd
+                        for (size_t b = 0; b < len; ++b) {
+                            cnt[b] += mj[b];
+                            si[b] += xi * mj[b];
+                            sj[b] += xj[b];
+                            sii[b] += xi * xi * mj[b];
+                            sjj[b] += xj[b] * xj[b];
+                            sij[b] += xi * xj[b];
+                        }
+                    }
+                    for (size_t b = 0; b < len; ++b) {
+                        size_t j = j0 + b;
+                        if (j <= i) continue;
+                        if (overlap) (*overlap)[i * n + j] = (*overlap)[j * n + i] = uint32_t(cnt[b]);
+                        if (cnt[b] < min_overlap) continue;
+                        double vi = cnt[b] * sii[b] - si[b] * si[b], vj = cnt[b] * sjj[b] - sj[b] * sj[b];
+                        if (!(vi > 0 && vj > 0)) continue;
+                        double r = (cnt[b] * sij[b] - si[b] * sj[b]) / std::sqrt(vi * vj);
+                        corr[i * n + j] = corr[j * n + i] = std::max(-1.0, std::min(1.0, r));
+                    }
+                }
+            }
+        }
+    }
+    return corr;
+}
+
+std::vector<double> pairwise_l1(const float* x, size_t n, size_t dim) { return all_pairs<true>(x, n, dim); }
+
+std::vector<double> pairwise_dot(const float* x, size_t n, size_t dim) { return all_pairs<false>(x, n, dim); }
+
+}  // namespace cne
@@ -0,0 +1,31 @@
+#pragma once
+
+// All-pairs reductions over the rows of a dense row-major matrix. Pairs are
+// processed in tiles of rows (and chunks of columns) so that both sides stay
+// in cache while the innermost loop vectorises; tile rows are distributed over
+// threads. pairwise_l1 and pairwise_dot return the packed upper triangle of a
+// .tri (netio.h).
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace cne {
+
+// sum_k |x_ik - x_jk| for every i < j
+std::vector<double> pairwise_l1(const float* x, size_t n, size_t dim);
+
+// sum_k x_ik x_jk for every i < j
+std::vector<double> pairwise_dot(const float* x, size_t n, size_t dim);
+
+// Pearson correlation between the rows of the n x dim matrix x over the
+// columns where both rows are present (present[i * dim + k] != 0), as a dense
+// symmetric n x n matrix with unit diagonal. Pairs sharing fewer than
+// `min_overlap` columns, or constant over the shared ones, get 0; `overlap`,
+// if given, receives the shared column counts in the same layout. Meant for
+// short series (dim of a few dozen) and many rows: the inner loop runs over a
+// block of rows j for one row i and one column at a time.
+std::vector<double> pairwise_correlation(const double* x, const uint8_t* present, size_t n, size_t dim,
+                                         size_t min_overlap, std::vector<uint32_t>* overlap = nullptr);
+
+}  // namespace cne
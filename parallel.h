@@ -0,0 +1,27 @@
+#pragma once
+
+// OpenMP thread helpers that also compile without OpenMP.
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace cne {
+
+inline int thread_count() {
+#ifdef _OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+inline int thread_id() {
+#ifdef _OPENMP
+    return omp_get_thread_num();
+#else
+    return 0;
+#endif
+}
+
+}  // namespace cne
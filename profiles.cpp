@@ -0,0 +1,33 @@
+#include "profiles.h"
+
+#include <cmath>
+
+namespace cne {
+
+void correlation_profile(const double* rca, size_t n, float* out) {
+    std::vector<double> x(n);
+    double mean = 0;
+    for (size_t j = 0; j < n; ++j) {
+        x[j] = std::log(rca[j] + 1e-10);
+        mean += x[j];
+    }
+    mean /= n;
+    double norm = 0;
+    for (size_t j = 0; j < n; ++j) {
+        x[j] -= mean;
+        norm += x[j] * x[j];
+    }
+    norm = std::sqrt(norm);
+    // Relative test: constant rows leave only rounding noise after centring
+    bool flat = norm <= 1e-12 * std::sqrt(double(n)) * (std::fabs(mean) + 1);
+    for (size_t j = 0; j < n; ++j) out[j] = flat ? 0.0f : float(x[j] / norm);
+}
+
+std::vector<float> correlation_profiles(const Matrix& rca) {
+    std::vector<float> out(rca.rows * rca.cols);
+#pragma omp parallel for schedule(static)
+    for (uint64_t i = 0; i < rca.rows; ++i) correlation_profile(rca.row(i), rca.cols, &out[i * rca.cols]);
+    return out;
+}
+
+}  // namespace cne
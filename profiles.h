@@ -0,0 +1,16 @@
+#pragma once
+
+#include "netio.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace cne {
+
+// Rows of log(R + 1e-10), centred and scaled to unit length, so that the dot
+// product of two rows equals their Pearson correlation as computed by
+// loc_prox.py. Rows without variance become zero vectors (correlation 0).
+void correlation_profile(const double* rca, size_t n, float* out);
+std::vector<float> correlation_profiles(const Matrix& rca);
+
+}  // namespace cne
@@ -0,0 +1,24 @@
+import socket
+import json
+import sys
+
+
+def query(line, socket_path="/tmp/cne.sock"):
+    """
+    Send one request line to query_daemon and return the decoded JSON answer,
+    e.g. query("top loc 3550308 20") or query("neighbors tmfg 3550308")
+    """
+    with socket.socket(socket.AF_UNIX, socket.SOCK_STREAM) as s:
+        s.connect(socket_path)
+        s.sendall(line.encode("utf-8") + b"\n")
+        data = b""
+        while not data.endswith(b"\n"):
+            chunk = s.recv(65536)
+            if not chunk:
+                break
+            data += chunk
+    return json.loads(data)
+
+
+if __name__ == "__main__":
+    print(json.dumps(query(" ".join(sys.argv[1:])), indent=2))
@@ -0,0 +1,309 @@
+// Keeps proximity matrices, filtered graphs and ICE tables resident in memory
+// and answers lookups over a Unix domain socket.
+//
+//   query_daemon --socket /tmp/cne.sock
+//                --matrix loc=Data/prox/location_proximity_matrix.mat
+//                --graph tmfg=results/2023_loc_tmfg.csr
+//                --ice Data/ice_scenarios.mat
+//
+// Requests are single text lines, responses single JSON lines, in order:
+//   top <matrix> <label> <k>        most related labels by proximity
+//   neighbors <graph> <label>       adjacency of a node in a filtered graph
+//   ice <label> <scenario>          ICE value, scenario = column of the --ice table
+//   ping
+// Every line that arrives during one poll wakeup is answered as one batch.
+
+#include "cli.h"
+#include "netio.h"
+
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdint>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace cne;
+
+namespace {
+
+struct Store {
+    std::map<std::string, Matrix> matrices;
+    std::map<std::string, Csr> graphs;
+    Matrix ice;
+    bool has_ice = false;
+};
+
+struct Connection {
+    std::string in, out;
+    size_t sent = 0;  // bytes of `out` already written
+};
+
+struct Request {
+    int fd;
+    std::string line;
+    std::string response;
+};
+
+std::string json_string(const std::string& s) {
+    std::string r = "\"";
+    for (char c : s) {
+        if (c == '"' || c == '\\') r += '\\';
+        r += c;
+    }
+    return r + "\"";
+}
+
+std::string error(const std::string& msg) {
+    return "{\"ok\":false,\"error\":" + json_string(msg) + "}";
+}
+
+std::string format_number(double v) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.10g", v);
+    return buf;
+}
+
+std::string answer_top(const Store& store, const std::string& name, const std::string& label, size_t k) {
+    auto it = store.matrices.find(name);
+    if (it == store.matrices.end()) return error("unknown matrix " + name);
+    const Matrix& m = it->second;
+    int64_t i = m.row_labels.find(label);
+    if (i < 0) return error("unknown label " + label);
+
+    // Single pass keeping the k best columns in a min-heap
+    k = std::min<size_t>(k, m.cols);
+    const double* row = m.row(i);
+    int64_t self = m.col_labels.find(label);
+    std::vector<std::pair<double, uint32_t>> best;
+    best.reserve(k + 1);
+    auto worse = [](const std::pair<double, uint32_t>& a, const std::pair<double, uint32_t>& b) {
+        return a.first > b.first;
+    };
+    for (uint32_t j = 0; j < m.cols; ++j) {
+        if (j == self || k == 0) continue;
+        if (best.size() < k) {
+            best.emplace_back(row[j], j);
+            std::push_heap(best.begin(), best.end(), worse);
+        } else if (row[j] > best.front().first) {
+            std::pop_heap(best.begin(), best.end(), worse);
+            best.back() = {row[j], j};
+            std::push_heap(best.begin(), best.end(), worse);
+        }
+    }
+    std::sort_heap(best.begin(), best.end(), worse);
+
+    std::string r = "{\"ok\":true,\"results\":[";
+    for (size_t n = 0; n < best.size(); ++n) {
+        if (n) r += ',';
+        r += "{\"label\":" + json_string(m.col_labels[best[n].second]) +
+             ",\"value\":" + format_number(best[n].first) + "}";
+    }
+    return r + "]}";
+}
+
+std::string answer_neighbors(const Store& store, const std::string& name, const std::string& label) {
+    auto it = store.graphs.find(name);
+    if (it == store.graphs.end()) return error("unknown graph " + name);
+    const Csr& g = it->second;
+    int64_t i = g.row_labels.find(label);
+    if (i < 0) return error("unknown label " + label);
+
+    std::string r = "{\"ok\":true,\"results\":[";
+    for (uint64_t e = g.offsets[i]; e < g.offsets[i + 1]; ++e) {
+        if (e != g.offsets[i]) r += ',';
+        r += "{\"label\":" + json_string(g.col_labels[g.indices[e]]) +
+             ",\"value\":" + format_number(g.values[e]) + "}";
+    }
+    return r + "]}";
+}
+
+std::string answer_ice(const Store& store, const std::string& label, const std::string& scenario) {
+    if (!store.has_ice) return error("no ICE table loaded");
+    int64_t i = store.ice.row_labels.find(label);
+    if (i < 0) return error("unknown label " + label);
+    int64_t j = store.ice.col_labels.find(scenario);
+    if (j < 0) return error("unknown scenario " + scenario);
+    return "{\"ok\":true,\"value\":" + format_number(store.ice.at(i, j)) + "}";
+}
+
+std::string answer(const Store& store, const std::string& line) {
+    std::istringstream in(line);
+    std::string cmd, a, b;
+    in >> cmd;
+    if (cmd == "ping") return "{\"ok\":true}";
+    if (cmd == "top") {
+        size_t k = 20;
+        std::string count;
+        if (!(in >> a >> b)) return error("usage: top <matrix> <label> [k]");
+        if (in >> count) {
+            char* end = nullptr;
+            errno = 0;
+            unsigned long long parsed = std::strtoull(count.c_str(), &end, 10);
+            if (!std::isdigit(static_cast<unsigned char>(count[0])) || *end || errno == ERANGE)
+                return error("k must be a non-negative integer, got " + count);
+            k = size_t(std::min<unsigned long long>(parsed, SIZE_MAX));
+        }
+        return answer_top(store, a, b, k);
+    }
+    if (cmd == "neighbors") {
+        if (!(in >> a >> b)) return error("usage: neighbors <graph> <label>");
+        return answer_neighbors(store, a, b);
+    }
+    if (cmd == "ice") {
+        if (!(in >> a >> b)) return error("usage: ice <label> <scenario>");
+        return answer_ice(store, a, b);
+    }
+    return error("unknown command " + cmd);
+}
+
+std::pair<std::string, std::string> split_named(const std::string& spec) {
+    auto eq = spec.find('=');
+    if (eq == std::string::npos) throw std::runtime_error("expected NAME=PATH, got " + spec);
+    return {spec.substr(0, eq), spec.substr(eq + 1)};
+}
+
+void set_nonblocking(int fd) { ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK); }
+
+// Writes as much pending output as the socket accepts; false if the peer is gone.
+bool flush(int fd, Connection& c) {
+    while (c.sent < c.out.size()) {
+        ssize_t n = ::send(fd, c.out.data() + c.sent, c.out.size() - c.sent, MSG_NOSIGNAL);
+        if (n < 0) return errno == EAGAIN || errno == EWOULDBLOCK;
+        c.sent += n;
+    }
+    c.out.clear();
+    c.sent = 0;
+    return true;
+}
+
+int serve(const Store& store, const std::string& socket_path) {
+    int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (socket_path.size() >= sizeof(addr.sun_path)) throw std::runtime_error("socket path too long");
+    std::strcpy(addr.sun_path, socket_path.c_str());
+    ::unlink(socket_path.c_str());
+    if (::bind(listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || ::listen(listener, 128) != 0)
+        throw std::runtime_error(socket_path + ": " + std::strerror(errno));
+    set_nonblocking(listener);
+
+    int ep = ::epoll_create1(0);
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = listener;
+    ::epoll_ctl(ep, EPOLL_CTL_ADD, listener, &ev);
+
+    std::map<int, Connection> conns;
+    std::vector<epoll_event> events(256);
+    std::vector<Request> batch;
+    std::cout << "Listening on " << socket_path << std::endl;
+
+    for (;;) {
+        int n = ::epoll_wait(ep, events.data(), events.size(), -1);
+        if (n < 0 && errno == EINTR) continue;
+        batch.clear();
+
+        for (int e = 0; e < n; ++e) {
+            int fd = events[e].data.fd;
+            if (fd == listener) {
+                int client;
+                while ((client = ::accept(listener, nullptr, nullptr)) >= 0) {
+                    set_nonblocking(client);
+                    epoll_event cev{};
+                    cev.events = EPOLLIN | EPOLLRDHUP;
+                    cev.data.fd = client;
+                    ::epoll_ctl(ep, EPOLL_CTL_ADD, client, &cev);
+                    conns[client];
+                }
+                continue;
+            }
+            Connection& c = conns[fd];
+            bool closed = (events[e].events & (EPOLLHUP | EPOLLERR)) != 0;
+            char buf[65536];
+            ssize_t r;
+            while ((r = ::recv(fd, buf, sizeof(buf), 0)) > 0) c.in.append(buf, r);
+            if (r == 0 || (r < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) closed = true;
+
+            size_t start = 0, nl, queued = batch.size();
+            while ((nl = c.in.find('\n', start)) != std::string::npos) {
+                batch.push_back({fd, c.in.substr(start, nl - start), {}});
+                start = nl + 1;
+            }
+            c.in.erase(0, start);
+            if (closed && batch.size() == queued) {
+                ::close(fd);
+                conns.erase(fd);
+            }
+        }
+
+        // Lookups are read-only, so a large batch is answered across threads.
+#pragma omp parallel for schedule(dynamic, 16) if (batch.size() > 64)
+        for (size_t i = 0; i < batch.size(); ++i) {
+            // An exception escaping the parallel loop would terminate the daemon
+            try {
+                batch[i].response = answer(store, batch[i].line);
+            } catch (const std::exception& e) {
+                batch[i].response = error(e.what());
+            }
+        }
+
+        for (auto& req : batch) conns[req.fd].out += req.response + '\n';
+        for (auto it = conns.begin(); it != conns.end();) {
+            epoll_event cev{};
+            cev.data.fd = it->first;
+            if (!flush(it->first, it->second)) {
+                ::close(it->first);
+                it = conns.erase(it);
+                continue;
+            }
+            cev.events = EPOLLIN | EPOLLRDHUP | (it->second.out.empty() ? 0u : uint32_t(EPOLLOUT));
+            ::epoll_ctl(ep, EPOLL_CTL_MOD, it->first, &cev);
+            ++it;
+        }
+    }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    try {
+        Args args(argc, argv);
+        Store store;
+        for (const auto& spec : args.all("matrix")) {
+            auto [name, path] = split_named(spec);
+            store.matrices[name] = load_matrix(path);
+            std::cout << "Loaded matrix " << name << ": " << store.matrices[name].rows << " x "
+                      << store.matrices[name].cols << std::endl;
+        }
+        for (const auto& spec : args.all("graph")) {
+            auto [name, path] = split_named(spec);
+            store.graphs[name] = load_csr(path);
+            std::cout << "Loaded graph " << name << ": " << store.graphs[name].rows << " nodes, "
+                      << store.graphs[name].nnz() / 2 << " edges" << std::endl;
+        }
+        if (args.has("ice")) {
+            store.ice = load_matrix(args.get("ice"));
+            store.has_ice = true;
+            std::cout << "Loaded ICE table with " << store.ice.cols << " scenarios" << std::endl;
+        }
+        std::signal(SIGPIPE, SIG_IGN);
+        return serve(store, args.get("socket", "/tmp/cne.sock"));
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,233 @@
+// RCA, binary matrix, product proximity and ICE from yearly count matrices,
+// optionally over sliding multi-year windows.
+//
+//   rca --counts 2019=Data/cnae/2019/counts.csr --counts 2020=Data/cnae/2020/counts.csr
+//       --counts 2021=Data/cnae/2021/counts.csr --counts 2022=Data/cnae/2022/counts.csr
+//       --window 3 --out Data/cnae/window [--threshold 1.0] [--save-rca]
+//   rca --counts 2022=Data/cnae/2022/counts.csr --threshold 0.5 --threshold 1 --threshold 1.5
+//       --threshold 2 --out Data/cnae/sensitivity [--save-m]
+//   rca --counts 2022=Data/cnae/2022/counts.csr --hierarchy cnae --out Data/cnae/levels
+//
+// Count matrices are locations x activities (export_bin.py counts). Each
+// window sums its years; moving to the next window adds the new year and
+// subtracts the oldest, then M, co-occurrence and the ICE eigenvector are
+// updated from the locations whose M row changed. Per window, writes to
+// <out>/<first>-<last>/: proximity.mat, ice.csv, diversity.csv, ubiquity.csv,
+// location_indices.csv (entropy, HHI, Theil and Krugman index per location),
+// activity_indices.csv (locational Gini per activity) and, with --save-rca,
+// rca.mat. The indices are accumulated in the same traversal that computes
+// RCA and M (Complexity::update); the Gini is per activity, not per location,
+// so it is kept in its own table rather than in location_indices.csv.
+//
+// Several --threshold values (up to 8) are evaluated together as bitplanes of
+// one M, so every pass over the changed rows updates all of them; each
+// threshold's outputs then go to <out>/<window>/threshold_<value>/. --save-m
+// writes the bit-sliced M as <out>/<window>/m.csr, whose values have bit t set
+// when RCA >= the t-th --threshold.
+//
+// --hierarchy cnae|cbo rolls the activity columns of every year up the CNAE
+// 2.0 or CBO 2002 code tree (hierarchy.h) and runs the windows once per
+// level, writing to <out>/<level>/<window>/; --level restricts the levels
+// (e.g. --level division --level group).
+
+#include "cli.h"
+#include "eci.h"
+#include "hierarchy.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace cne;
+
+namespace {
+
+struct Year {
+    std::string name;
+    Csr counts;
+    std::vector<uint32_t> row_map, col_map;
+};
+
+Matrix dense_rca(const CountWindow& window, const Labels& locations, const Labels& activities) {
+    size_t P = window.activities();
+    std::vector<double> values(window.locations() * P, 0.0);
+#pragma omp parallel for schedule(dynamic, 64)
+    for (size_t c = 0; c < window.locations(); ++c)
+        for (const auto& cell : window.row(c)) values[c * P + cell.first] = window.rca(c, cell);
+    Matrix m;
+    m.rows = window.locations();
+    m.cols = P;
+    m.row_labels = locations;
+    m.col_labels = activities;
+    m.values = Buffer<double>(std::move(values));
+    return m;
+}
+
+Csr sliced_m(const Complexity& eci, const Labels& locations, const Labels& activities) {
+    std::vector<uint64_t> offsets(1, 0);
+    std::vector<uint32_t> indices;
+    std::vector<double> values;
+    for (size_t c = 0; c < eci.locations(); ++c) {
+        for (const auto& [p, bits] : eci.row(c)) {
+            indices.push_back(p);
+            values.push_back(bits);
+        }
+        offsets.push_back(indices.size());
+    }
+    Csr m;
+    m.rows = eci.locations();
+    m.cols = eci.activities();
+    m.row_labels = locations;
+    m.col_labels = activities;
+    m.offsets = Buffer<uint64_t>(std::move(offsets));
+    m.indices = Buffer<uint32_t>(std::move(indices));
+    m.values = Buffer<double>(std::move(values));
+    return m;
+}
+
+void write_plane(const std::filesystem::path& dir, Complexity& eci, size_t plane, const CountWindow& window,
+                 const Labels& locations, const Labels& activities) {
+    std::filesystem::create_directories(dir);
+
+    Matrix phi;
+    phi.rows = phi.cols = activities.size();
+    phi.row_labels = phi.col_labels = activities;
+    phi.values = Buffer<double>(eci.proximity(plane));
+    save_matrix((dir / "proximity.mat").string(), phi);
+
+    std::vector<double> ice = eci.ice(plane);
+    std::ofstream ice_file(dir / "ice.csv");
+    ice_file << "Municipality_ID,ICE\n";
+    for (size_t c = 0; c < locations.size(); ++c)
+        if (eci.diversity(plane)[c]) ice_file << locations[c] << ',' << ice[c] << '\n';
+
+    std::ofstream diversity(dir / "diversity.csv");
+    diversity << ",Diversity\n";
+    for (size_t c = 0; c < locations.size(); ++c)
+        if (window.location_total(c) > 0) diversity << locations[c] << ',' << eci.diversity(plane)[c] << '\n';
+
+    std::ofstream ubiquity(dir / "ubiquity.csv");
+    ubiquity << ",Ubiquity\n";
+    for (size_t p = 0; p < activities.size(); ++p)
+        if (window.activity_total(p) > 0) ubiquity << activities[p] << ',' << eci.ubiquity(plane)[p] << '\n';
+}
+
+void write_indices(const std::filesystem::path& dir, const ConcentrationIndices& idx, const CountWindow& window,
+                   const Labels& locations, const Labels& activities) {
+    std::filesystem::create_directories(dir);
+    std::ofstream loc(dir / "location_indices.csv");
+    loc.precision(10);
+    loc << "Municipality_ID,Entropy,HHI,Theil,Krugman\n";
+    for (size_t c = 0; c < locations.size(); ++c)
+        if (window.location_total(c) > 0)
+            loc << locations[c] << ',' << idx.entropy[c] << ',' << idx.hhi[c] << ',' << idx.theil[c] << ','
+                << idx.krugman[c] << '\n';
+    std::ofstream act(dir / "activity_indices.csv");
+    act.precision(10);
+    act << ",Gini\n";
+    for (size_t p = 0; p < activities.size(); ++p)
+        if (window.activity_total(p) > 0) act << activities[p] << ',' << idx.gini[p] << '\n';
+    if (!loc || !act) throw std::runtime_error(dir.string() + ": cannot write indices");
+}
+
+void write_window(const std::filesystem::path& dir, Complexity& eci, const std::vector<std::string>& thresholds,
+                  const CountWindow& window, const ConcentrationIndices& indices, const Labels& locations,
+                  const Labels& activities, const Args& args) {
+    if (thresholds.size() == 1) {
+        write_plane(dir, eci, 0, window, locations, activities);
+    } else {
+        for (size_t t = 0; t < thresholds.size(); ++t)
+            write_plane(dir / ("threshold_" + thresholds[t]), eci, t, window, locations, activities);
+    }
+    write_indices(dir, indices, window, locations, activities);
+    if (args.has("save-rca")) save_matrix((dir / "rca.mat").string(), dense_rca(window, locations, activities));
+    if (args.has("save-m")) save_csr((dir / "m.csr").string(), sliced_m(eci, locations, activities));
+}
+
+// Aligns the years on the union of their location and activity labels and
+// writes every window under `out`
+void run_windows(std::vector<Year>& years, size_t width, const std::vector<std::string>& thresholds,
+                 const std::filesystem::path& out, const Args& args) {
+    Labels locations, activities;
+    for (auto& y : years) {
+        y.row_map = remap_labels(y.counts.row_labels, locations);
+        y.col_map = remap_labels(y.counts.col_labels, activities);
+    }
+    std::vector<double> values;
+    for (const auto& t : thresholds) values.push_back(std::stod(t));
+
+    CountWindow window(locations.size(), activities.size());
+    Complexity eci(locations.size(), activities.size(), values);
+    for (size_t t = 0; t < width; ++t) window.add(years[t].counts, years[t].row_map, years[t].col_map, 1.0);
+
+    for (size_t first = 0;; ++first) {
+        size_t last = first + width - 1;
+        ConcentrationIndices indices;
+        size_t changed = eci.update(window, &indices);
+        std::string tag = width == 1 ? years[first].name : years[first].name + "-" + years[last].name;
+        write_window(out / tag, eci, thresholds, window, indices, locations, activities, args);
+        std::cout << "Window " << tag << ": " << changed << " locations changed M" << std::endl;
+
+        if (last + 1 == years.size()) break;
+        window.add(years[last + 1].counts, years[last + 1].row_map, years[last + 1].col_map, 1.0);
+        window.add(years[first].counts, years[first].row_map, years[first].col_map, -1.0);
+    }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    try {
+        Args args(argc, argv);
+        size_t width = args.integer("window", 1);
+        std::vector<std::string> thresholds = args.all("threshold");
+        if (thresholds.empty()) thresholds = {"1.0"};
+        std::filesystem::path out = args.get("out");
+
+        std::vector<Year> years;
+        for (const auto& spec : args.all("counts")) {
+            auto eq = spec.find('=');
+            if (eq == std::string::npos) throw std::runtime_error("expected YEAR=PATH, got " + spec);
+            Year y{spec.substr(0, eq), load_csr(spec.substr(eq + 1)), {}, {}};
+            std::cout << "Year " << y.name << ": " << y.counts.rows << " locations x " << y.counts.cols
+                      << " activities, " << y.counts.nnz() << " non-zero cells" << std::endl;
+            years.push_back(std::move(y));
+        }
+        if (width == 0 || years.size() < width) throw std::runtime_error("need at least --window years of --counts");
+
+        if (!args.has("hierarchy")) {
+            run_windows(years, width, thresholds, out, args);
+            return 0;
+        }
+
+        // Every year rolled up to every level in one pass, then each level
+        // runs the windows on its own
+        std::string scheme = args.get("hierarchy");
+        std::vector<std::string> names;
+        std::vector<std::vector<Year>> by_level;
+        for (const auto& y : years) {
+            std::vector<HierarchyLevel> levels = activity_hierarchy(y.counts.col_labels, scheme);
+            std::vector<Csr> rolled = roll_up(y.counts, levels);
+            if (by_level.empty()) {
+                for (const auto& level : levels) names.push_back(level.name);
+                by_level.resize(levels.size());
+            }
+            if (levels.size() != names.size() || levels[0].name != names[0])
+                throw std::runtime_error("year " + y.name + " has codes at a different level than the first year");
+            for (size_t l = 0; l < levels.size(); ++l) by_level[l].push_back({y.name, std::move(rolled[l]), {}, {}});
+        }
+        std::vector<std::string> wanted = args.all("level");
+        for (size_t l = 0; l < names.size(); ++l) {
+            if (!wanted.empty() && std::find(wanted.begin(), wanted.end(), names[l]) == wanted.end()) continue;
+            std::cout << "Level " << names[l] << ": " << by_level[l][0].counts.cols << " activities" << std::endl;
+            run_windows(by_level[l], width, thresholds, out / names[l], args);
+        }
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
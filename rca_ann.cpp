@@ -0,0 +1,168 @@
+// Approximate "most similar economic profile" queries over location RCA rows.
+//
+//   rca_ann build --rca Data/cnae/2023/normalized_2023.mat --index loc_2023.hnsw
+//   rca_ann query --index loc_2023.hnsw --label 3550308 --label 3304557 --k 20
+//   rca_ann query --index loc_2023.hnsw --labels-file municipalities.txt --out similar.csv
+//   rca_ann query --index loc_2023.hnsw --profiles hypothetical_rca.mat
+//   rca_ann knn --index loc_2023.hnsw --k 30 --out loc_2023_knn.csr
+//
+// Similarities are correlations of log-RCA, the same quantity loc_prox.py
+// puts in the location proximity matrix. --profiles takes RCA rows for new or
+// hypothetical locations; its columns are matched to the index by activity label.
+// knn writes every location's k nearest neighbours as a (directed) graph, the
+// candidate input of `filter --candidates`.
+
+#include "cli.h"
+#include "hnsw.h"
+#include "profiles.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace cne;
+
+namespace {
+
+struct Query {
+    std::string name;
+    std::vector<float> profile;
+    int64_t self = -1;  // index node to leave out of the answer
+};
+
+std::vector<Query> collect_queries(const Args& args, const HnswIndex& index) {
+    std::vector<Query> queries;
+    std::vector<std::string> names = args.all("label");
+    if (args.has("labels-file")) {
+        std::ifstream in(args.get("labels-file"));
+        for (std::string line; std::getline(in, line);)
+            if (!line.empty()) names.push_back(line);
+    }
+    for (const auto& name : names) {
+        int64_t id = index.labels().find(name);
+        if (id < 0) throw std::runtime_error("unknown label " + name);
+        const float* v = index.vector(id);
+        queries.push_back({name, std::vector<float>(v, v + index.dim()), id});
+    }
+
+    if (args.has("profiles")) {
+        Matrix m = load_matrix(args.get("profiles"));
+        // Activities missing from a profile count as RCA 0
+        std::vector<double> aligned(index.dim());
+        for (uint64_t i = 0; i < m.rows; ++i) {
+            std::fill(aligned.begin(), aligned.end(), 0.0);
+            for (uint64_t j = 0; j < m.cols; ++j) {
+                int64_t f = index.features().find(m.col_labels[j]);
+                if (f >= 0) aligned[f] = m.at(i, j);
+            }
+            Query q{m.row_labels[i], std::vector<float>(index.dim()), -1};
+            correlation_profile(aligned.data(), aligned.size(), q.profile.data());
+            queries.push_back(std::move(q));
+        }
+    }
+    return queries;
+}
+
+int build(const Args& args) {
+    Matrix rca = load_matrix(args.get("rca"));
+    std::cout << "RCA matrix: " << rca.rows << " locations x " << rca.cols << " activities" << std::endl;
+
+    HnswIndex::Params params;
+    params.M = args.integer("M", params.M);
+    params.ef_construction = args.integer("ef-construction", params.ef_construction);
+    params.seed = args.integer("seed", params.seed);
+    HnswIndex index(correlation_profiles(rca), rca.cols, rca.row_labels, rca.col_labels, params);
+    index.save(args.get("index"));
+    std::cout << "Index saved to " << args.get("index") << std::endl;
+    return 0;
+}
+
+int query(const Args& args) {
+    HnswIndex index = HnswIndex::load(args.get("index"));
+    size_t k = args.integer("k", 20);
+    size_t ef = args.integer("ef", 64);
+    std::vector<Query> queries = collect_queries(args, index);
+
+    std::vector<HnswIndex::Results> results(queries.size());
+#pragma omp parallel for schedule(dynamic)
+    for (size_t q = 0; q < queries.size(); ++q) {
+        // Ask for one extra hit so the query location itself can be dropped
+        auto r = index.search(queries[q].profile.data(), k + 1, ef);
+        for (auto it = r.begin(); it != r.end(); ++it)
+            if (it->second == queries[q].self) {
+                r.erase(it);
+                break;
+            }
+        if (r.size() > k) r.resize(k);
+        results[q] = std::move(r);
+    }
+
+    std::ofstream file;
+    if (args.has("out")) file.open(args.get("out"));
+    std::ostream& out = args.has("out") ? file : std::cout;
+    out << "query,rank,label,correlation\n";
+    for (size_t q = 0; q < queries.size(); ++q)
+        for (size_t r = 0; r < results[q].size(); ++r)
+            out << queries[q].name << ',' << r + 1 << ',' << index.labels()[results[q][r].second] << ','
+                << results[q][r].first << '\n';
+    return 0;
+}
+
+int knn(const Args& args) {
+    HnswIndex index = HnswIndex::load(args.get("index"));
+    size_t k = args.integer("k", 30);
+    size_t ef = std::max<size_t>(args.integer("ef", 64), k + 1);
+    size_t n = index.size();
+
+    std::vector<HnswIndex::Results> results(n);
+#pragma omp parallel for schedule(dynamic, 64)
+    for (size_t q = 0; q < n; ++q) {
+        auto r = index.search(index.vector(q), k + 1, ef);
+        r.erase(std::remove_if(r.begin(), r.end(), [q](const auto& hit) { return hit.second == q; }), r.end());
+        if (r.size() > k) r.resize(k);
+        results[q] = std::move(r);
+    }
+
+    std::vector<uint64_t> offsets(n + 1, 0);
+    for (size_t q = 0; q < n; ++q) offsets[q + 1] = offsets[q] + results[q].size();
+    std::vector<uint32_t> indices(offsets[n]);
+    std::vector<double> values(offsets[n]);
+    for (size_t q = 0; q < n; ++q) {
+        // Column order within a row, as everywhere else in .csr files
+        std::sort(results[q].begin(), results[q].end(),
+                  [](const auto& a, const auto& b) { return a.second < b.second; });
+        for (size_t r = 0; r < results[q].size(); ++r) {
+            indices[offsets[q] + r] = uint32_t(results[q][r].second);
+            values[offsets[q] + r] = results[q][r].first;
+        }
+    }
+    Csr g;
+    g.rows = g.cols = n;
+    g.row_labels = g.col_labels = index.labels();
+    g.offsets = Buffer<uint64_t>(std::move(offsets));
+    g.indices = Buffer<uint32_t>(std::move(indices));
+    g.values = Buffer<double>(std::move(values));
+    save_csr(args.get("out"), g);
+    std::cout << "Candidate graph: " << n << " nodes, " << g.nnz() << " arcs saved to " << args.get("out")
+              << std::endl;
+    return 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    try {
+        Args args(argc, argv);
+        std::string mode = args.positional().empty() ? "" : args.positional()[0];
+        if (mode == "build") return build(args);
+        if (mode == "query") return query(args);
+        if (mode == "knn") return knn(args);
+        std::cerr << "usage: rca_ann build|query|knn [options]" << std::endl;
+        return 1;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+// Small, fast generator (xoshiro256**) seeded through splitmix64 so that
+// independent streams can be derived from one seed per thread or per run.
+
+#include <cstdint>
+
+namespace cne {
+
+// Stateless 64-bit mixer (the splitmix64 finaliser), for hashing ids.
+inline uint64_t mix64(uint64_t z) {
+    z += 0x9e3779b97f4a7c15ULL;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+class Rng {
+public:
+    explicit Rng(uint64_t seed, uint64_t stream = 0) {
+        uint64_t x = seed ^ (0x9e3779b97f4a7c15ULL * (stream + 1));
+        for (auto& s : s_) s = splitmix64(x);
+    }
+
+    uint64_t next() {
+        uint64_t result = rotl(s_[1] * 5, 7) * 9;
+        uint64_t t = s_[1] << 17;
+        s_[2] ^= s_[0];
+        s_[3] ^= s_[1];
+        s_[1] ^= s_[2];
+        s_[0] ^= s_[3];
+        s_[2] ^= t;
+        s_[3] = rotl(s_[3], 45);
+        return result;
+    }
+
+    // Uniform in [0, 1)
+    double uniform() { return (next() >> 11) * 0x1.0p-53; }
+
+    // Uniform in [0, n)
+    uint64_t below(uint64_t n) { return uint64_t(uniform() * n); }
+
+private:
+    static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+    static uint64_t splitmix64(uint64_t& x) {
+        uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    uint64_t s_[4];
+};
+
+}  // namespace cne
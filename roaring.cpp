@@ -0,0 +1,194 @@
+#include "roaring.h"
+
+#include <algorithm>
+
+namespace cne {
+
+namespace {
+
+constexpr size_t kArrayMax = 4096;
+constexpr size_t kBitmapWords = 1024;
+
+// Number of set bits of `words` in [first, last], clipped to `size` words
+size_t range_count(const uint64_t* words, size_t size, size_t first, size_t last) {
+    size_t lo = first >> 6, hi = last >> 6;
+    if (lo >= size) return 0;
+    uint64_t lo_mask = ~uint64_t(0) << (first & 63);
+    uint64_t hi_mask = ~uint64_t(0) >> (63 - (last & 63));
+    if (lo == hi) return __builtin_popcountll(words[lo] & lo_mask & hi_mask);
+    size_t count = __builtin_popcountll(words[lo] & lo_mask);
+    for (size_t k = lo + 1; k < std::min(hi, size); ++k) count += __builtin_popcountll(words[k]);
+    if (hi < size) count += __builtin_popcountll(words[hi] & hi_mask);
+    return count;
+}
+
+// Sorted-array intersection: linear merge for similar sizes, galloping
+// (exponential then binary search) from the smaller side otherwise
+size_t array_array(const std::vector<uint16_t>& a, const std::vector<uint16_t>& b) {
+    const std::vector<uint16_t>& small = a.size() <= b.size() ? a : b;
+    const std::vector<uint16_t>& large = a.size() <= b.size() ? b : a;
+    size_t count = 0;
+    if (large.size() > 32 * small.size()) {
+        auto from = large.begin();
+        for (uint16_t v : small) {
+            size_t step = 1;
+            auto hi = from;
+            while (hi != large.end() && *hi < v) {
+                from = hi;
+                hi = size_t(large.end() - hi) > step ? hi + step : large.end();
+                step *= 2;
+            }
+            from = std::lower_bound(from, hi, v);
+            if (from == large.end()) break;
+            count += *from == v;
+        }
+        return count;
+    }
+    size_t i = 0, j = 0;
+    while (i < a.size() && j < b.size()) {
+        if (a[i] < b[j]) {
+            ++i;
+        } else if (b[j] < a[i]) {
+            ++j;
+        } else {
+            ++count, ++i, ++j;
+        }
+    }
+    return count;
+}
+
+size_t array_bitmap(const std::vector<uint16_t>& a, const std::vector<uint64_t>& words) {
+    size_t count = 0;
+    for (uint16_t v : a) count += (words[v >> 6] >> (v & 63)) & 1;
+    return count;
+}
+
+size_t array_run(const std::vector<uint16_t>& a, const std::vector<uint16_t>& runs) {
+    size_t count = 0, r = 0;
+    for (uint16_t v : a) {
+        while (r < runs.size() && runs[r + 1] < v) r += 2;
+        if (r == runs.size()) break;
+        count += runs[r] <= v;
+    }
+    return count;
+}
+
+size_t run_run(const std::vector<uint16_t>& a, const std::vector<uint16_t>& b) {
+    size_t count = 0, i = 0, j = 0;
+    while (i < a.size() && j < b.size()) {
+        uint32_t lo = std::max(a[i], b[j]), hi = std::min(a[i + 1], b[j + 1]);
+        if (lo <= hi) count += hi - lo + 1;
+        (a[i + 1] < b[j + 1] ? i : j) += 2;
+    }
+    return count;
+}
+
+}  // namespace
+
+Roaring Roaring::from_sorted(const uint32_t* ids, size_t n) {
+    Roaring r;
+    r.cardinality_ = n;
+    for (size_t i = 0; i < n;) {
+        uint16_t key = uint16_t(ids[i] >> 16);
+        size_t j = i;
+        while (j < n && (ids[j] >> 16) == key) ++j;
+        size_t runs = 1;
+        for (size_t k = i + 1; k < j; ++k) runs += ids[k] != ids[k - 1] + 1;
+
+        Container c{key, Kind::Array, uint32_t(j - i), {}, {}};
+        size_t array_bytes = 2 * (j - i), run_bytes = 4 * runs, bitmap_bytes = 8 * kBitmapWords;
+        if (run_bytes < std::min(array_bytes, bitmap_bytes)) {
+            c.kind = Kind::Run;
+            for (size_t k = i; k < j; ++k) {
+                if (k == i || ids[k] != ids[k - 1] + 1) c.values.push_back(uint16_t(ids[k]));
+                if (k + 1 == j || ids[k + 1] != ids[k] + 1) c.values.push_back(uint16_t(ids[k]));
+            }
+        } else if (j - i <= kArrayMax) {
+            for (size_t k = i; k < j; ++k) c.values.push_back(uint16_t(ids[k]));
+        } else {
+            c.kind = Kind::Bitmap;
+            c.words.assign(kBitmapWords, 0);
+            for (size_t k = i; k < j; ++k) c.words[(ids[k] & 0xffff) >> 6] |= uint64_t(1) << (ids[k] & 63);
+        }
+        r.containers_.push_back(std::move(c));
+        i = j;
+    }
+    return r;
+}
+
+bool Roaring::contains(uint32_t id) const {
+    uint16_t key = uint16_t(id >> 16), low = uint16_t(id);
+    auto it = std::lower_bound(containers_.begin(), containers_.end(), key,
+                               [](const Container& c, uint16_t k) { return c.key < k; });
+    if (it == containers_.end() || it->key != key) return false;
+    if (it->kind == Kind::Bitmap) return (it->words[low >> 6] >> (low & 63)) & 1;
+    if (it->kind == Kind::Array) return std::binary_search(it->values.begin(), it->values.end(), low);
+    for (size_t r = 0; r < it->values.size(); r += 2)
+        if (low <= it->values[r + 1]) return low >= it->values[r];
+    return false;
+}
+
+size_t Roaring::bytes() const {
+    size_t total = 0;
+    for (const auto& c : containers_) total += sizeof(Container) + 2 * c.values.size() + 8 * c.words.size();
+    return total;
+}
+
+size_t Roaring::intersect(const Container& a, const Container& b) {
+    if (a.kind == Kind::Bitmap && b.kind == Kind::Bitmap) {
+        size_t count = 0;
+        for (size_t k = 0; k < kBitmapWords; ++k) count += __builtin_popcountll(a.words[k] & b.words[k]);
+        return count;
+    }
+    if (b.kind == Kind::Array && a.kind != Kind::Array) return intersect(b, a);
+    if (a.kind == Kind::Array) {
+        if (b.kind == Kind::Array) return array_array(a.values, b.values);
+        if (b.kind == Kind::Bitmap) return array_bitmap(a.values, b.words);
+        return array_run(a.values, b.values);
+    }
+    if (a.kind == Kind::Bitmap) return intersect(b, a);
+    // a is runs, b runs or a bitmap
+    if (b.kind == Kind::Run) return run_run(a.values, b.values);
+    size_t count = 0;
+    for (size_t r = 0; r < a.values.size(); r += 2)
+        count += range_count(b.words.data(), kBitmapWords, a.values[r], a.values[r + 1]);
+    return count;
+}
+
+size_t intersection_count(const Roaring& a, const Roaring& b) {
+    size_t count = 0, i = 0, j = 0;
+    while (i < a.containers_.size() && j < b.containers_.size()) {
+        uint16_t ka = a.containers_[i].key, kb = b.containers_[j].key;
+        if (ka < kb) {
+            ++i;
+        } else if (kb < ka) {
+            ++j;
+        } else {
+            count += Roaring::intersect(a.containers_[i++], b.containers_[j++]);
+        }
+    }
+    return count;
+}
+
+size_t intersection_count(const Roaring& a, const Bitset& b) {
+    const std::vector<uint64_t>& words = b.words();
+    size_t count = 0;
+    for (const auto& c : a.containers_) {
+        size_t base = size_t(c.key) * kBitmapWords;  // first word of this container in b
+        if (base >= words.size()) break;
+        size_t available = std::min(kBitmapWords, words.size() - base);
+        const uint64_t* w = words.data() + base;
+        if (c.kind == Roaring::Kind::Array) {
+            for (uint16_t v : c.values)
+                if (size_t(v >> 6) < available) count += (w[v >> 6] >> (v & 63)) & 1;
+        } else if (c.kind == Roaring::Kind::Bitmap) {
+            for (size_t k = 0; k < available; ++k) count += __builtin_popcountll(c.words[k] & w[k]);
+        } else {
+            for (size_t r = 0; r < c.values.size(); r += 2)
+                count += range_count(w, available, c.values[r], c.values[r + 1]);
+        }
+    }
+    return count;
+}
+
+}  // namespace cne
@@ -0,0 +1,75 @@
+#pragma once
+
+// Compressed bitmap over uint32 ids in the style of Roaring (Chambi, Lemire
+// et al. 2016), for sets that are far sparser than a dense Bitset pays for,
+// such as the municipalities where a rare activity has RCA >= 1. Ids are
+// split by their high 16 bits into containers holding the low 16 bits as a
+// sorted array (at most 4096 values), a 65536-bit bitmap or runs of
+// consecutive values, whichever is smallest. Sets are built once from sorted
+// ids and then only queried.
+
+#include "bitset.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace cne {
+
+class Roaring {
+public:
+    enum class Kind : uint8_t { Array, Bitmap, Run };
+
+    Roaring() = default;
+
+    // `ids` ascending, without duplicates
+    static Roaring from_sorted(const uint32_t* ids, size_t n);
+
+    size_t cardinality() const { return cardinality_; }
+    bool contains(uint32_t id) const;
+    size_t bytes() const;  // payload size
+
+    // Calls f(id) for every member, ascending
+    template <typename F>
+    void for_each(F f) const {
+        for (const auto& c : containers_) {
+            uint32_t high = uint32_t(c.key) << 16;
+            if (c.kind == Kind::Array) {
+                for (uint16_t v : c.values) f(high | v);
+            } else if (c.kind == Kind::Bitmap) {
+                for (size_t k = 0; k < c.words.size(); ++k)
+                    for (uint64_t w = c.words[k]; w; w &= w - 1) f(high | uint32_t(k * 64 + __builtin_ctzll(w)));
+            } else {
+                for (size_t r = 0; r < c.values.size(); r += 2)
+                    for (uint32_t v = c.values[r]; v <= c.values[r + 1]; ++v) f(high | v);
+            }
+        }
+    }
+
+    friend size_t intersection_count(const Roaring& a, const Roaring& b);
+    friend size_t intersection_count(const Roaring& a, const Bitset& b);
+
+private:
+    struct Container {
+        uint16_t key;  // high 16 bits
+        Kind kind;
+        uint32_t cardinality;
+        std::vector<uint16_t> values;  // Array: sorted values; Run: (first, last) pairs
+        std::vector<uint64_t> words;   // Bitmap: 1024 words
+    };
+
+    static size_t intersect(const Container& a, const Container& b);
+
+    std::vector<Container> containers_;  // by key
+    size_t cardinality_ = 0;
+};
+
+// |a & b|, container by container with the cheapest method for each pair of
+// kinds (merge or galloping for arrays, popcount for bitmaps, range sweeps
+// for runs)
+size_t intersection_count(const Roaring& a, const Roaring& b);
+
+// |a & b| with b a dense set over the same ids
+size_t intersection_count(const Roaring& a, const Bitset& b);
+
+}  // namespace cne
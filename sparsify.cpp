@@ -0,0 +1,130 @@
+// Spectral sparsification of a dense proximity graph (Spielman & Srivastava
+// 2008), an alternative to the thresholding in matrix_to_adj.py.
+//
+//   sparsify --tri Data/prox/location_proximity_matrix.tri --epsilon 0.5
+//            --out results/2023_loc_sparse.csr
+//   sparsify --tri Data/prox/product_proximity_matrix.tri --edges 20000 --out results/2023_prod_sparse.csr
+//
+// Every positive entry of the .tri (export_bin.py tri) is an edge e; it is
+// kept with probability p_e = min(1, q w_e R_e), its weight scaled to w_e / p_e,
+// where R_e comes from a --sketch dimensional effective resistance sketch.
+// q = --oversample * ln(n) / epsilon^2, or the value giving about --edges
+// edges in expectation. The kept edges are written as a symmetric .csr.
+// x^T L x of the original and sparsified graphs is compared on a few random
+// cuts as a check.
+
+#include "cli.h"
+#include "edges.h"
+#include "laplacian.h"
+#include "rng.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace cne;
+
+int main(int argc, char** argv) {
+    try {
+        Args args(argc, argv);
+        Triangle t = load_triangle(args.get("tri"));
+        size_t n = t.n;
+        size_t k = args.integer("sketch", 48);
+        uint64_t seed = args.integer("seed", 1);
+        std::cout << "Dense graph: " << n << " nodes, " << t.values.size() << " pairs" << std::endl;
+
+        TriangleLaplacian op(t);
+        auto m = jacobi_preconditioner(op, 0.0);
+        PcgParams params;
+        params.tolerance = args.number("tolerance", 1e-6);
+        params.block = args.integer("block", params.block);
+        PcgStats stats;
+        std::vector<double> z = resistance_sketch(op, *m, k, seed, params, stats);
+        std::cout << "Resistance sketch: " << k << " dimensions, " << stats.iterations << " PCG iterations, residual "
+                  << stats.residual << std::endl;
+
+        // Leverage scores w_e R_e in triangle order
+        std::vector<float> score(t.values.size(), 0.0f);
+#pragma omp parallel for schedule(dynamic, 16)
+        for (size_t u = 0; u < n; ++u) {
+            const double* w = t.row(u);
+            const double* zu = &z[u * k];
+            float* su = &score[Triangle::row_offset(u, n)];
+            for (size_t v = u + 1; v < n; ++v) {
+                if (!(w[v - u - 1] > 0)) continue;
+                const double* zv = &z[v * k];
+                double r = 0;
+#pragma omp simd reduction(+ : r)
+                for (size_t d = 0; d < k; ++d) r += (zu[d] - zv[d]) * (zu[d] - zv[d]);
+                su[v - u - 1] = float(w[v - u - 1] * r);
+            }
+        }
+        auto expected = [&](double q) {
+            double sum = 0;
+#pragma omp parallel for reduction(+ : sum) schedule(static)
+            for (size_t e = 0; e < score.size(); ++e) sum += std::min(1.0, q * score[e]);
+            return sum;
+        };
+
+        double q;
+        if (args.has("edges")) {
+            // expected() is increasing in q: bisect on a log scale
+            double target = args.number("edges", 0), lo = 1e-12, hi = 1e12;
+            for (int it = 0; it < 100; ++it) {
+                double mid = std::sqrt(lo * hi);
+                (expected(mid) < target ? lo : hi) = mid;
+            }
+            q = hi;
+        } else {
+            double epsilon = args.number("epsilon", 0.5);
+            q = args.number("oversample", 1.0) * std::log(double(n)) / (epsilon * epsilon);
+        }
+        std::cout << "Sampling with q = " << q << ", " << expected(q) << " edges expected" << std::endl;
+
+        // One Rng stream per row, so the sample does not depend on the thread count
+        std::vector<EdgeList> rows(n);
+#pragma omp parallel for schedule(dynamic, 16)
+        for (size_t u = 0; u < n; ++u) {
+            Rng rng(seed, u);
+            const double* w = t.row(u);
+            const float* su = &score[Triangle::row_offset(u, n)];
+            for (size_t v = u + 1; v < n; ++v) {
+                if (!(w[v - u - 1] > 0)) continue;
+                double p = std::min(1.0, q * su[v - u - 1]);
+                if (rng.uniform() < p) {
+                    rows[u].keys.push_back(edge_key(uint32_t(u), uint32_t(v)));
+                    rows[u].weights.push_back(w[v - u - 1] / p);
+                }
+            }
+        }
+        EdgeList kept;
+        for (const auto& row : rows) {
+            kept.keys.insert(kept.keys.end(), row.keys.begin(), row.keys.end());
+            kept.weights.insert(kept.weights.end(), row.weights.begin(), row.weights.end());
+        }
+        Csr sparse = csr_from_edges(t.labels, kept);
+        save_csr(args.get("out"), sparse);
+        std::cout << "Sparsifier: " << kept.keys.size() << " edges saved to " << args.get("out") << std::endl;
+
+        // Cut check: x^T L_H x / x^T L_G x on random +-1 vectors
+        const size_t cuts = 8;
+        std::vector<double> x(n * cuts), lg(n * cuts), lh(n * cuts);
+        Rng rng(seed, n);
+        for (auto& e : x) e = (rng.next() >> 63) ? 1.0 : -1.0;
+        op.apply(x.data(), lg.data(), cuts, 0.0);
+        CsrLaplacian(sparse).apply(x.data(), lh.data(), cuts, 0.0);
+        double worst = 0;
+        for (size_t c = 0; c < cuts; ++c) {
+            double g = 0, h = 0;
+            for (size_t i = 0; i < n; ++i) g += x[c * n + i] * lg[c * n + i], h += x[c * n + i] * lh[c * n + i];
+            if (g > 0) worst = std::max(worst, std::abs(h / g - 1));
+        }
+        std::cout << "Largest relative cut deviation over " << cuts << " random cuts: " << worst << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
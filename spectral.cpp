@@ -0,0 +1,234 @@
+#include "spectral.h"
+
+#include "linalg.h"
+#include "parallel.h"
+#include "rng.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace cne {
+
+namespace {
+
+// Blocks of vectors are stored column by column: column j at [j * n].
+
+double dot(const double* a, const double* b, size_t n) {
+    double s = 0;
+#pragma omp parallel for simd reduction(+ : s) schedule(static)
+    for (size_t i = 0; i < n; ++i) s += a[i] * b[i];
+    return s;
+}
+
+// y = L x for `cols` columns, L = I - D^-1/2 A D^-1/2
+void apply_laplacian(const Csr& g, const std::vector<double>& dinv, const std::vector<double>& x,
+                     std::vector<double>& y, size_t cols) {
+    size_t n = g.rows;
+    y.resize(n * cols);
+#pragma omp parallel for schedule(dynamic, 256)
+    for (size_t i = 0; i < n; ++i)
+        for (size_t j = 0; j < cols; ++j) {
+            const double* xj = &x[j * n];
+            double s = 0;
+            for (uint64_t e = g.offsets[i]; e < g.offsets[i + 1]; ++e) s += g.values[e] * dinv[g.indices[e]] * xj[g.indices[e]];
+            y[j * n + i] = xj[i] - dinv[i] * s;
+        }
+}
+
+// Modified Gram-Schmidt, applied twice for stability. Columns that become
+// numerically dependent are dropped; returns the number kept.
+size_t orthonormalize(std::vector<double>& q, size_t n, size_t cols) {
+    size_t kept = 0;
+    for (size_t j = 0; j < cols; ++j) {
+        double* v = &q[j * n];
+        double before = std::sqrt(dot(v, v, n));
+        for (int pass = 0; pass < 2; ++pass)
+            for (size_t i = 0; i < kept; ++i) {
+                const double* u = &q[i * n];
+                double c = dot(u, v, n);
+#pragma omp parallel for simd schedule(static)
+                for (size_t r = 0; r < n; ++r) v[r] -= c * u[r];
+            }
+        double norm = std::sqrt(dot(v, v, n));
+        if (!(norm > 1e-10 * before) || norm < 1e-300) continue;
+        double* dst = &q[kept * n];
+#pragma omp parallel for simd schedule(static)
+        for (size_t r = 0; r < n; ++r) dst[r] = v[r] / norm;
+        ++kept;
+    }
+    q.resize(kept * n);
+    return kept;
+}
+
+// out = q * v[:, first .. first + cols), with q n x s and v s x s row-major
+void combine(const std::vector<double>& q, size_t n, size_t s, const std::vector<double>& v, size_t rows_from,
+             size_t first, size_t cols, std::vector<double>& out) {
+    out.assign(n * cols, 0.0);
+#pragma omp parallel for schedule(static)
+    for (size_t r = 0; r < n; ++r)
+        for (size_t j = 0; j < cols; ++j) {
+            double acc = 0;
+            for (size_t i = rows_from; i < s; ++i) acc += q[i * n + r] * v[i * s + first + j];
+            out[j * n + r] = acc;
+        }
+}
+
+}  // namespace
+
+Eigenpairs normalized_laplacian_eigs(const Csr& g, size_t k, const LobpcgParams& params) {
+    size_t n = g.rows;
+    if (g.cols != n) throw std::runtime_error("spectral: adjacency must be square");
+    if (k == 0 || k > n) throw std::runtime_error("spectral: need 0 < k <= nodes");
+
+    std::vector<double> dinv(n, 0.0);
+    for (size_t i = 0; i < n; ++i) {
+        double d = 0;
+        for (uint64_t e = g.offsets[i]; e < g.offsets[i + 1]; ++e) {
+            if (g.values[e] < 0) throw std::runtime_error("spectral: negative edge weight");
+            d += g.values[e];
+        }
+        dinv[i] = d > 0 ? 1 / std::sqrt(d) : 0.0;
+    }
+
+    // A few guard vectors beyond k speed up convergence of the k-th pair
+    size_t m = std::min(n, k + std::min<size_t>(k, 4));
+    std::vector<double> x(n * m), lx, p, q, lq, v, lambda;
+    Rng rng(params.seed);
+    for (auto& e : x) e = rng.uniform() - 0.5;
+    if (orthonormalize(x, n, m) != m) throw std::runtime_error("spectral: degenerate start block");
+
+    // Rayleigh-Ritz on an orthonormal basis q of s columns: m lowest Ritz pairs
+    auto rayleigh_ritz = [&](size_t s) {
+        apply_laplacian(g, dinv, q, lq, s);
+        std::vector<double> h(s * s);
+        for (size_t a = 0; a < s; ++a)
+            for (size_t b = a; b < s; ++b) h[a * s + b] = h[b * s + a] = dot(&q[a * n], &lq[b * n], n);
+        lambda.resize(s);
+        v.resize(s * s);
+        symmetric_eigen(h.data(), s, lambda.data(), v.data());
+    };
+
+    q = x;
+    rayleigh_ritz(m);
+    combine(q, n, m, v, 0, 0, m, x);
+    combine(lq, n, m, v, 0, 0, m, lx);
+
+    Eigenpairs out;
+    std::vector<double> r(n * m);
+    for (size_t it = 1;; ++it) {
+        double worst = 0;
+        for (size_t j = 0; j < m; ++j) {
+#pragma omp parallel for simd schedule(static)
+            for (size_t i = 0; i < n; ++i) r[j * n + i] = lx[j * n + i] - lambda[j] * x[j * n + i];
+            if (j < k) worst = std::max(worst, std::sqrt(dot(&r[j * n], &r[j * n], n)));
+        }
+        out.iterations = it;
+        out.residual = worst;
+        if (worst < params.tolerance || it >= params.max_iterations) break;
+
+        // Basis [X R P]; X is orthonormal and comes first, so it survives intact
+        size_t cols = 2 * m + (p.empty() ? 0 : m);
+        q.resize(n * cols);
+        std::copy(x.begin(), x.end(), q.begin());
+        std::copy(r.begin(), r.end(), q.begin() + n * m);
+        if (!p.empty()) std::copy(p.begin(), p.end(), q.begin() + 2 * n * m);
+        size_t s = orthonormalize(q, n, cols);
+        rayleigh_ritz(s);
+        combine(q, n, s, v, 0, 0, m, x);
+        combine(lq, n, s, v, 0, 0, m, lx);
+        // Search direction: the part of the new X outside the old one
+        combine(q, n, s, v, m, 0, m, p);
+    }
+
+    out.values.assign(lambda.begin(), lambda.begin() + k);
+    out.vectors.resize(n * k);
+    for (size_t i = 0; i < n; ++i)
+        for (size_t j = 0; j < k; ++j) out.vectors[i * k + j] = x[j * n + i];
+    return out;
+}
+
+Clustering kmeans(const std::vector<double>& points, size_t dim, size_t k, size_t restarts, uint64_t seed,
+                  size_t max_iterations) {
+    size_t n = dim ? points.size() / dim : 0;
+    if (k == 0 || k > n) throw std::runtime_error("kmeans: need 0 < k <= points");
+    auto distance2 = [&](size_t i, const double* c) {
+        double s = 0;
+        for (size_t d = 0; d < dim; ++d) s += (points[i * dim + d] - c[d]) * (points[i * dim + d] - c[d]);
+        return s;
+    };
+
+    Clustering best;
+    best.inertia = std::numeric_limits<double>::infinity();
+    for (size_t run = 0; run < std::max<size_t>(restarts, 1); ++run) {
+        Rng rng(seed, run);
+        Clustering c;
+        c.labels.assign(n, 0);
+        c.centroids.assign(k * dim, 0.0);
+
+        // k-means++: each new centre drawn with probability ~ squared distance
+        // to the nearest chosen one
+        std::vector<double> d2(n, std::numeric_limits<double>::infinity());
+        size_t pick = rng.below(n);
+        for (size_t j = 0; j < k; ++j) {
+            std::copy(&points[pick * dim], &points[pick * dim] + dim, &c.centroids[j * dim]);
+            double total = 0;
+#pragma omp parallel for reduction(+ : total) schedule(static)
+            for (size_t i = 0; i < n; ++i) {
+                d2[i] = std::min(d2[i], distance2(i, &c.centroids[j * dim]));
+                total += d2[i];
+            }
+            if (total <= 0) {
+                pick = rng.below(n);  // all points coincide with centres
+                continue;
+            }
+            double target = rng.uniform() * total;
+            for (pick = 0; pick + 1 < n && (target -= d2[pick]) > 0; ++pick) {
+            }
+        }
+
+        // Lloyd iterations with per-thread centroid sums
+        size_t threads = thread_count();
+        std::vector<double> sums(threads * k * dim);
+        std::vector<size_t> counts(threads * k);
+        for (size_t it = 0; it < max_iterations; ++it) {
+            std::fill(sums.begin(), sums.end(), 0.0);
+            std::fill(counts.begin(), counts.end(), 0);
+            size_t changed = 0;
+            double inertia = 0;
+#pragma omp parallel for reduction(+ : changed, inertia) schedule(static)
+            for (size_t i = 0; i < n; ++i) {
+                uint32_t label = 0;
+                double nearest = std::numeric_limits<double>::infinity();
+                for (size_t j = 0; j < k; ++j) {
+                    double d = distance2(i, &c.centroids[j * dim]);
+                    if (d < nearest) nearest = d, label = uint32_t(j);
+                }
+                changed += label != c.labels[i];
+                c.labels[i] = label;
+                inertia += nearest;
+                size_t t = thread_id();
+                ++counts[t * k + label];
+                for (size_t d = 0; d < dim; ++d) sums[(t * k + label) * dim + d] += points[i * dim + d];
+            }
+            c.inertia = inertia;
+            if (it > 0 && changed == 0) break;
+            for (size_t j = 0; j < k; ++j) {
+                size_t count = 0;
+                std::vector<double> centre(dim, 0.0);
+                for (size_t t = 0; t < threads; ++t) {
+                    count += counts[t * k + j];
+                    for (size_t d = 0; d < dim; ++d) centre[d] += sums[(t * k + j) * dim + d];
+                }
+                // An empty cluster keeps its centre
+                if (count)
+                    for (size_t d = 0; d < dim; ++d) c.centroids[j * dim + d] = centre[d] / count;
+            }
+        }
+        if (c.inertia < best.inertia) best = std::move(c);
+    }
+    return best;
+}
+
+}  // namespace cne
@@ -0,0 +1,41 @@
+#pragma once
+
+// Spectral partitions and Laplacian eigenmaps of filtered networks, a
+// complement to the modularity communities computed in Python.
+
+#include "netio.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace cne {
+
+// k smallest eigenpairs of the normalised Laplacian L = I - D^-1/2 A D^-1/2
+// of a symmetric adjacency with non-negative weights, by LOBPCG (Knyazev
+// 2001) with the Rayleigh-Ritz basis [X R P] orthonormalised explicitly.
+// Isolated nodes contribute eigenvalue 1.
+struct Eigenpairs {
+    std::vector<double> values;   // ascending, k of them
+    std::vector<double> vectors;  // n x k row-major, unit columns
+    size_t iterations = 0;
+    double residual = 0;  // largest ||L x - lambda x|| at exit
+};
+struct LobpcgParams {
+    size_t max_iterations = 1000;
+    double tolerance = 1e-6;
+    uint64_t seed = 1;
+};
+Eigenpairs normalized_laplacian_eigs(const Csr& adjacency, size_t k, const LobpcgParams& params = {});
+
+// Lloyd's k-means on n points of dimension `dim` (row-major), seeded by
+// k-means++. `restarts` independent runs; the one with the lowest inertia
+// wins. Distance updates and assignments run in parallel.
+struct Clustering {
+    std::vector<uint32_t> labels;
+    std::vector<double> centroids;  // k x dim
+    double inertia = 0;
+};
+Clustering kmeans(const std::vector<double>& points, size_t dim, size_t k, size_t restarts = 8,
+                  uint64_t seed = 1, size_t max_iterations = 300);
+
+}  // namespace cne
@@ -0,0 +1,187 @@
+// Year-over-year comparison of filtered networks (e.g. one TMFG per RAIS year).
+//
+//   temporal --graph 2020=results/2020_loc_tmfg.csr --graph 2022=results/2022_loc_tmfg.csr
+//            --graph 2023=results/2023_loc_tmfg.csr --out results/temporal
+//
+// Graphs are aligned on their node labels. Writes to --out:
+//   summary.csv   per consecutive pair: edge counts, common/added/removed, Jaccard
+//   edges.csv     per edge seen in any year: years present, first/last year, mean weight
+//   nodes.csv     per node and consecutive pair: degrees, added/removed edges,
+//                 churn (1 - Jaccard of incident edges), weight drift on kept edges
+//   diff_<a>_<b>.bin  changed edges as packed records {uint32 u, uint32 v,
+//                 float32 w_a, float32 w_b}, NaN for a missing side; u and v are
+//                 line numbers in labels.txt
+//   labels.txt    shared node labels
+
+#include "cli.h"
+#include "edges.h"
+
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+using namespace cne;
+
+namespace {
+
+struct Year {
+    std::string name;
+    EdgeList edges;
+};
+
+struct PairStats {
+    uint64_t common = 0, added = 0, removed = 0;
+    double jaccard = 0;
+    // per node
+    std::vector<uint32_t> degree_from, degree_to, node_added, node_removed;
+    std::vector<double> drift;
+};
+
+struct DiffRecord {
+    uint32_t u, v;
+    float w_from, w_to;
+};
+static_assert(sizeof(DiffRecord) == 16, "diff record layout");
+
+// One sorted merge of two consecutive edge sets gives every pairwise statistic.
+PairStats compare(const EdgeList& a, const EdgeList& b, size_t n, std::vector<DiffRecord>& diff) {
+    PairStats s;
+    s.degree_from.assign(n, 0);
+    s.degree_to.assign(n, 0);
+    s.node_added.assign(n, 0);
+    s.node_removed.assign(n, 0);
+    s.drift.assign(n, 0.0);
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+
+    size_t i = 0, j = 0;
+    while (i < a.keys.size() || j < b.keys.size()) {
+        bool take_a = j == b.keys.size() || (i < a.keys.size() && a.keys[i] <= b.keys[j]);
+        bool take_b = i == a.keys.size() || (j < b.keys.size() && b.keys[j] <= a.keys[i]);
+        uint64_t key = take_a ? a.keys[i] : b.keys[j];
+        uint32_t u = edge_first(key), v = edge_second(key);
+        if (take_a && take_b) {
+            double d = std::fabs(b.weights[j] - a.weights[i]);
+            ++s.common;
+            ++s.degree_from[u], ++s.degree_from[v];
+            ++s.degree_to[u], ++s.degree_to[v];
+            s.drift[u] += d;
+            s.drift[v] += d;
+            if (d > 0) diff.push_back({u, v, float(a.weights[i]), float(b.weights[j])});
+            ++i, ++j;
+        } else if (take_a) {
+            ++s.removed;
+            ++s.degree_from[u], ++s.degree_from[v];
+            ++s.node_removed[u], ++s.node_removed[v];
+            diff.push_back({u, v, float(a.weights[i]), nan});
+            ++i;
+        } else {
+            ++s.added;
+            ++s.degree_to[u], ++s.degree_to[v];
+            ++s.node_added[u], ++s.node_added[v];
+            diff.push_back({u, v, nan, float(b.weights[j])});
+            ++j;
+        }
+    }
+    uint64_t total = s.common + s.added + s.removed;
+    s.jaccard = total ? double(s.common) / total : 1.0;
+    return s;
+}
+
+void write_diff(const std::string& path, const std::vector<DiffRecord>& diff) {
+    std::ofstream out(path, std::ios::binary);
+    out.write(reinterpret_cast<const char*>(diff.data()), diff.size() * sizeof(DiffRecord));
+    if (!out) throw std::runtime_error(path + ": write failed");
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    try {
+        Args args(argc, argv);
+        namespace fs = std::filesystem;
+        fs::path out_dir = args.get("out", "results/temporal");
+        fs::create_directories(out_dir);
+
+        Labels labels;
+        std::vector<Year> years;
+        for (const auto& spec : args.all("graph")) {
+            auto eq = spec.find('=');
+            if (eq == std::string::npos) throw std::runtime_error("expected YEAR=PATH, got " + spec);
+            Csr g = load_csr(spec.substr(eq + 1));
+            years.push_back({spec.substr(0, eq), edge_list(g, remap_labels(g.row_labels, labels))});
+            std::cout << "Year " << years.back().name << ": " << g.rows << " nodes, "
+                      << years.back().edges.keys.size() << " edges" << std::endl;
+        }
+        if (years.size() < 2) throw std::runtime_error("need at least two --graph YEAR=PATH inputs");
+        size_t n = labels.size();
+
+        // Consecutive pairs are independent
+        size_t pairs = years.size() - 1;
+        std::vector<PairStats> stats(pairs);
+        std::vector<std::vector<DiffRecord>> diffs(pairs);
+#pragma omp parallel for schedule(dynamic)
+        for (size_t t = 0; t < pairs; ++t) stats[t] = compare(years[t].edges, years[t + 1].edges, n, diffs[t]);
+
+        std::ofstream summary(out_dir / "summary.csv");
+        summary << "from,to,edges_from,edges_to,common,added,removed,jaccard\n";
+        for (size_t t = 0; t < pairs; ++t) {
+            const auto& s = stats[t];
+            summary << years[t].name << ',' << years[t + 1].name << ',' << years[t].edges.keys.size() << ','
+                    << years[t + 1].edges.keys.size() << ',' << s.common << ',' << s.added << ',' << s.removed
+                    << ',' << s.jaccard << '\n';
+            write_diff((out_dir / ("diff_" + years[t].name + "_" + years[t + 1].name + ".bin")).string(), diffs[t]);
+            std::cout << years[t].name << " -> " << years[t + 1].name << ": Jaccard " << s.jaccard << ", "
+                      << s.added << " added, " << s.removed << " removed" << std::endl;
+        }
+
+        std::ofstream nodes(out_dir / "nodes.csv");
+        nodes << "label,from,to,degree_from,degree_to,added,removed,churn,weight_drift\n";
+        for (size_t t = 0; t < pairs; ++t) {
+            const auto& s = stats[t];
+            for (size_t u = 0; u < n; ++u) {
+                uint32_t kept = s.degree_from[u] - s.node_removed[u];
+                uint32_t incident = kept + s.node_removed[u] + s.node_added[u];
+                if (!incident) continue;
+                nodes << labels[u] << ',' << years[t].name << ',' << years[t + 1].name << ',' << s.degree_from[u]
+                      << ',' << s.degree_to[u] << ',' << s.node_added[u] << ',' << s.node_removed[u] << ','
+                      << 1.0 - double(kept) / incident << ',' << s.drift[u] << '\n';
+            }
+        }
+
+        // k-way merge over all years for persistence
+        std::ofstream edges(out_dir / "edges.csv");
+        edges << "source,target,years_present,persistence,first,last,mean_weight\n";
+        std::vector<size_t> pos(years.size(), 0);
+        for (;;) {
+            uint64_t key = UINT64_MAX;
+            for (size_t t = 0; t < years.size(); ++t)
+                if (pos[t] < years[t].edges.keys.size()) key = std::min(key, years[t].edges.keys[pos[t]]);
+            if (key == UINT64_MAX) break;
+            int present = 0, first = -1, last = -1;
+            double sum = 0;
+            for (size_t t = 0; t < years.size(); ++t) {
+                if (pos[t] < years[t].edges.keys.size() && years[t].edges.keys[pos[t]] == key) {
+                    sum += years[t].edges.weights[pos[t]++];
+                    if (first < 0) first = t;
+                    last = t;
+                    ++present;
+                }
+            }
+            edges << labels[edge_first(key)] << ',' << labels[edge_second(key)] << ',' << present << ','
+                  << double(present) / years.size() << ',' << years[first].name << ',' << years[last].name << ','
+                  << sum / present << '\n';
+        }
+
+        std::ofstream label_file(out_dir / "labels.txt");
+        for (const auto& name : labels.names) label_file << name << '\n';
+        std::cout << "Temporal comparison saved to " << out_dir.string() << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,153 @@
+#include "filtering.h"
+
+#include "rng.h"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+namespace cne {
+
+namespace {
+
+using Face = std::array<uint32_t, 3>;
+
+// Vertices ordered by the sum of their weights that exceed the mean
+// off-diagonal weight; the canonical initial tetrahedron is the first four.
+std::vector<uint32_t> strength_order(const Matrix& w, size_t count) {
+    size_t n = w.rows;
+    double mean = 0;
+    for (size_t i = 0; i < n; ++i)
+        for (size_t j = 0; j < n; ++j)
+            if (i != j) mean += w.at(i, j);
+    mean /= double(n) * (n - 1);
+
+    std::vector<double> strength(n, 0.0);
+#pragma omp parallel for schedule(static)
+    for (size_t i = 0; i < n; ++i) {
+        const double* row = w.row(i);
+        for (size_t j = 0; j < n; ++j)
+            if (i != j && row[j] > mean) strength[i] += row[j];
+    }
+    std::vector<uint32_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    count = std::min(std::max<size_t>(count, 4), n);
+    std::partial_sort(order.begin(), order.begin() + count, order.end(),
+                      [&](uint32_t a, uint32_t b) { return strength[a] > strength[b]; });
+    order.resize(count);
+    return order;
+}
+
+void check_input(const Matrix& w) {
+    if (w.cols != w.rows) throw std::runtime_error("tmfg: weight matrix must be square");
+    if (w.rows < 4) throw std::runtime_error("tmfg: need at least 4 nodes");
+}
+
+CliqueForest run(const Matrix& w, std::vector<uint32_t> pool, uint64_t seed) {
+    size_t n = w.rows;
+    if (seed) {
+        Rng rng(seed);
+        for (size_t i = 0; i < 4; ++i) std::swap(pool[i], pool[i + rng.below(pool.size() - i)]);
+    }
+    // Among equal gains, the smaller key wins: vertex order for seed 0,
+    // a seed-dependent permutation otherwise
+    auto tie_key = [seed](uint64_t x) { return seed ? mix64(seed ^ mix64(x)) : x; };
+
+    CliqueForest out;
+    std::vector<char> inserted(n, 0);
+    std::vector<std::pair<uint32_t, uint32_t>> edges;
+    std::array<uint32_t, 4> c0 = {pool[0], pool[1], pool[2], pool[3]};
+    out.cliques.push_back({c0[0], c0[1], c0[2], c0[3]});
+    for (int a = 0; a < 4; ++a) {
+        inserted[c0[a]] = 1;
+        for (int b = a + 1; b < 4; ++b) edges.emplace_back(c0[a], c0[b]);
+    }
+
+    std::vector<Face> faces = {Face{c0[0], c0[1], c0[2]}, Face{c0[0], c0[1], c0[3]},
+                               Face{c0[0], c0[2], c0[3]}, Face{c0[1], c0[2], c0[3]}};
+    std::vector<uint32_t> best(faces.size());
+    std::vector<double> gain(faces.size());
+    const double none = -std::numeric_limits<double>::infinity();
+
+    // Best outside vertex for one face: O(n)
+    auto rescore = [&](size_t f) {
+        const double* ra = w.row(faces[f][0]);
+        const double* rb = w.row(faces[f][1]);
+        const double* rc = w.row(faces[f][2]);
+        double g = none;
+        uint32_t v = 0;
+        for (uint32_t u = 0; u < n; ++u) {
+            if (inserted[u]) continue;
+            double s = ra[u] + rb[u] + rc[u];
+            if (s > g || (s == g && tie_key(u) < tie_key(v))) g = s, v = u;
+        }
+        best[f] = v;
+        gain[f] = g;
+    };
+    for (size_t f = 0; f < faces.size(); ++f) rescore(f);
+
+    for (size_t step = 4; step < n; ++step) {
+        size_t f = 0;
+        for (size_t g = 1; g < faces.size(); ++g)
+            if (gain[g] > gain[f] || (gain[g] == gain[f] && tie_key(g) < tie_key(f))) f = g;
+        uint32_t v = best[f];
+        Face face = faces[f];
+        inserted[v] = 1;
+        out.cliques.push_back({face[0], face[1], face[2], v});
+        out.separators.push_back({face[0], face[1], face[2]});
+        for (uint32_t u : face) edges.emplace_back(u, v);
+
+        // The used face splits into three; faces that wanted v look again
+        faces[f] = {face[0], face[1], v};
+        faces.push_back({face[0], face[2], v});
+        faces.push_back({face[1], face[2], v});
+        best.resize(faces.size());
+        gain.resize(faces.size());
+        if (step + 1 == n) break;
+        std::vector<size_t> stale;
+        for (size_t g = 0; g < faces.size(); ++g)
+            if (g == f || g + 2 >= faces.size() || best[g] == v) stale.push_back(g);
+#pragma omp parallel for schedule(dynamic) if (stale.size() > 8)
+        for (size_t s = 0; s < stale.size(); ++s) rescore(stale[s]);
+    }
+
+    std::vector<std::pair<uint64_t, double>> keyed;
+    for (const auto& [u, v] : edges) keyed.emplace_back(edge_key(u, v), w.at(u, v));
+    std::sort(keyed.begin(), keyed.end());
+    for (const auto& [key, weight] : keyed) {
+        out.edges.keys.push_back(key);
+        out.edges.weights.push_back(weight);
+        out.total_weight += weight;
+    }
+    return out;
+}
+
+}  // namespace
+
+CliqueForest tmfg(const Matrix& w, const TmfgParams& params) {
+    check_input(w);
+    return run(w, strength_order(w, params.seed ? params.seed_pool : 4), params.seed);
+}
+
+CliqueForest tmfg_restarts(const Matrix& w, size_t runs, size_t seed_pool, std::vector<double>& scores) {
+    check_input(w);
+    if (runs == 0) throw std::runtime_error("tmfg: need at least one run");
+    std::vector<uint32_t> pool = strength_order(w, seed_pool);
+    std::vector<CliqueForest> results(runs);
+
+    // One run per thread; the nested loops inside run() stay serial
+#pragma omp parallel for schedule(dynamic, 1)
+    for (size_t s = 0; s < runs; ++s) results[s] = run(w, pool, s);
+
+    scores.resize(runs);
+    size_t best = 0;
+    for (size_t s = 0; s < runs; ++s) {
+        scores[s] = results[s].total_weight;
+        if (scores[s] > scores[best]) best = s;
+    }
+    return std::move(results[best]);
+}
+
+}  // namespace cne
@@ -0,0 +1,160 @@
+#include "filtering.h"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+namespace cne {
+
+namespace {
+
+using Face = std::array<uint32_t, 3>;
+using Neighbors = std::vector<std::pair<uint32_t, double>>;  // sorted by node id
+
+// Undirected, deduplicated candidate lists: a top-k graph is not symmetric,
+// and a vertex must be reachable from its neighbours' faces.
+std::vector<Neighbors> symmetric_lists(const Csr& g) {
+    std::vector<Neighbors> lists(g.rows);
+    for (uint64_t u = 0; u < g.rows; ++u)
+        for (uint64_t e = g.offsets[u]; e < g.offsets[u + 1]; ++e) {
+            uint32_t v = g.indices[e];
+            if (v == u) continue;
+            lists[u].emplace_back(v, g.values[e]);
+            lists[v].emplace_back(uint32_t(u), g.values[e]);
+        }
+#pragma omp parallel for schedule(dynamic, 64)
+    for (size_t u = 0; u < lists.size(); ++u) {
+        auto& l = lists[u];
+        std::sort(l.begin(), l.end());
+        l.erase(std::unique(l.begin(), l.end(), [](const auto& a, const auto& b) { return a.first == b.first; }),
+                l.end());
+    }
+    return lists;
+}
+
+}  // namespace
+
+CliqueForest tmfg_sparse(const Csr& candidates, const ExactWeight& exact) {
+    size_t n = candidates.rows;
+    if (candidates.cols != n) throw std::runtime_error("tmfg: candidate graph must be square");
+    if (n < 4) throw std::runtime_error("tmfg: need at least 4 nodes");
+    std::vector<Neighbors> lists = symmetric_lists(candidates);
+
+    auto weight = [&](uint32_t u, uint32_t v) {
+        const auto& l = lists[u];
+        auto it = std::lower_bound(l.begin(), l.end(), std::make_pair(v, -std::numeric_limits<double>::infinity()));
+        return it != l.end() && it->first == v ? it->second : exact(u, v);
+    };
+
+    // Strength over candidate weights above their mean picks the initial tetrahedron
+    double mean = 0, count = 0;
+    for (const auto& l : lists)
+        for (const auto& e : l) mean += e.second, ++count;
+    mean /= std::max(count, 1.0);
+    std::vector<double> strength(n, 0.0);
+    for (size_t u = 0; u < n; ++u)
+        for (const auto& e : lists[u])
+            if (e.second > mean) strength[u] += e.second;
+    std::vector<uint32_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::partial_sort(order.begin(), order.begin() + 4, order.end(),
+                      [&](uint32_t a, uint32_t b) { return strength[a] > strength[b]; });
+
+    CliqueForest out;
+    std::vector<char> inserted(n, 0);
+    std::vector<std::pair<uint32_t, uint32_t>> edges;
+    uint32_t c0[4] = {order[0], order[1], order[2], order[3]};
+    out.cliques.push_back({c0[0], c0[1], c0[2], c0[3]});
+    for (int a = 0; a < 4; ++a) {
+        inserted[c0[a]] = 1;
+        for (int b = a + 1; b < 4; ++b) edges.emplace_back(c0[a], c0[b]);
+    }
+
+    std::vector<Face> faces = {Face{c0[0], c0[1], c0[2]}, Face{c0[0], c0[1], c0[3]},
+                               Face{c0[0], c0[2], c0[3]}, Face{c0[1], c0[2], c0[3]}};
+    std::vector<uint32_t> best(faces.size());
+    std::vector<double> gain(faces.size());
+    const double none = -std::numeric_limits<double>::infinity();
+
+    // Each face keeps its candidates ranked by gain (best last), so a face
+    // whose best vertex was taken pops the next one instead of recomputing;
+    // only new faces cost lookups. A face whose candidates are all inserted
+    // goes dormant (gain = none).
+    std::vector<std::vector<std::pair<double, uint32_t>>> ranked(faces.size());
+    auto pop = [&](size_t f) {
+        auto& r = ranked[f];
+        while (!r.empty() && inserted[r.back().second]) r.pop_back();
+        best[f] = r.empty() ? 0 : r.back().second;
+        gain[f] = r.empty() ? none : r.back().first;
+    };
+    auto rank = [&](size_t f) {
+        const Face& face = faces[f];
+        std::vector<uint32_t> pool;
+        for (uint32_t x : face)
+            for (const auto& e : lists[x])
+                if (!inserted[e.first]) pool.push_back(e.first);
+        std::sort(pool.begin(), pool.end());
+        pool.erase(std::unique(pool.begin(), pool.end()), pool.end());
+        auto& r = ranked[f];
+        r.clear();
+        for (uint32_t u : pool) r.emplace_back(weight(face[0], u) + weight(face[1], u) + weight(face[2], u), u);
+        // Ascending gain, and among equal gains the smaller vertex last
+        std::sort(r.begin(), r.end(), [](const auto& a, const auto& b) {
+            return a.first < b.first || (a.first == b.first && a.second > b.second);
+        });
+        pop(f);
+    };
+    for (size_t f = 0; f < faces.size(); ++f) rank(f);
+
+    for (size_t step = 4; step < n; ++step) {
+        size_t f = std::max_element(gain.begin(), gain.end()) - gain.begin();
+        if (gain[f] == none) {
+            // Every face is dormant: no remaining vertex is a candidate of an
+            // inserted one. Place the strongest remaining vertex on its best
+            // face by exact lookups; its own candidates then join new faces.
+            uint32_t u = 0;
+            while (inserted[u]) ++u;
+            for (uint32_t x = u + 1; x < n; ++x)
+                if (!inserted[x] && strength[x] > strength[u]) u = x;
+#pragma omp parallel for schedule(static)
+            for (size_t g = 0; g < faces.size(); ++g) {
+                best[g] = u;
+                gain[g] = weight(faces[g][0], u) + weight(faces[g][1], u) + weight(faces[g][2], u);
+            }
+            f = std::max_element(gain.begin(), gain.end()) - gain.begin();
+        }
+        uint32_t v = best[f];
+        Face face = faces[f];
+        inserted[v] = 1;
+        out.cliques.push_back({face[0], face[1], face[2], v});
+        out.separators.push_back({face[0], face[1], face[2]});
+        for (uint32_t u : face) edges.emplace_back(u, v);
+
+        // The used face splits into three; faces that wanted v look again
+        faces[f] = {face[0], face[1], v};
+        faces.push_back({face[0], face[2], v});
+        faces.push_back({face[1], face[2], v});
+        best.resize(faces.size());
+        gain.resize(faces.size());
+        ranked.resize(faces.size());
+        if (step + 1 == n) break;
+#pragma omp parallel for schedule(dynamic)
+        for (size_t s = 0; s < 3; ++s) rank(s ? faces.size() - s : f);
+        for (size_t g = 0; g < faces.size(); ++g)
+            if (best[g] == v) pop(g);
+    }
+
+    std::vector<std::pair<uint64_t, double>> keyed;
+    for (const auto& [u, v] : edges) keyed.emplace_back(edge_key(u, v), weight(u, v));
+    std::sort(keyed.begin(), keyed.end());
+    for (const auto& [key, w] : keyed) {
+        out.edges.keys.push_back(key);
+        out.edges.weights.push_back(w);
+        out.total_weight += w;
+    }
+    return out;
+}
+
+}  // namespace cne
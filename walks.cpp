@@ -0,0 +1,202 @@
+// Random-walk corpus for node2vec / DeepWalk embeddings of a filtered network.
+//
+//   walks --graph results/2023_loc_tmfg.csr --walks 100 --length 80 --out results/2023_loc
+//   walks --graph results/2023_prod_tmfg.csr --p 0.5 --q 2 --out results/2023_prod
+//
+// Writes <out>.walks, walks x length packed uint32 node ids (row-major, walk
+// r * nodes + v starts at node v; a walk stuck at an isolated node is padded
+// with 0xffffffff), and <out>_labels.txt with the label of each id. In Python:
+//   np.fromfile("2023_loc.walks", dtype=np.uint32).reshape(-1, 80)
+//
+// Transitions follow edge weights (--unweighted for uniform ones) through
+// alias tables. With p or q != 1 the walk is second order (Grover & Leskovec
+// 2016): one alias table per arc, or rejection sampling against the first
+// order tables when those would exceed --max-table-mb.
+
+#include "alias.h"
+#include "cli.h"
+#include "netio.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+using namespace cne;
+
+namespace {
+
+const uint32_t kNone = std::numeric_limits<uint32_t>::max();
+
+struct Walker {
+    const Csr& g;
+    std::vector<double> weights;
+    double p, q;
+
+    // First order: one table per node over its arcs
+    std::vector<float> prob;
+    std::vector<uint32_t> alias;
+    // Second order: one table per arc t->v over v's arcs, at arc_offsets[arc]
+    std::vector<uint64_t> arc_offsets;
+    std::vector<float> prob2;
+    std::vector<uint32_t> alias2;
+
+    bool second_order() const { return p != 1 || q != 1; }
+
+    bool adjacent(uint32_t t, uint32_t x) const {
+        const uint32_t* begin = g.indices.data() + g.offsets[t];
+        const uint32_t* end = g.indices.data() + g.offsets[t + 1];
+        return std::binary_search(begin, end, x);
+    }
+
+    double bias(uint32_t t, uint32_t x) const { return x == t ? 1 / p : adjacent(t, x) ? 1.0 : 1 / q; }
+
+    void build_first_order() {
+        prob.resize(g.nnz());
+        alias.resize(g.nnz());
+#pragma omp parallel for schedule(dynamic, 256)
+        for (size_t v = 0; v < g.rows; ++v) {
+            uint64_t b = g.offsets[v];
+            build_alias(&weights[b], g.degree(v), &prob[b], &alias[b]);
+        }
+    }
+
+    void build_second_order() {
+        arc_offsets.assign(g.nnz() + 1, 0);
+        for (uint64_t e = 0; e < g.nnz(); ++e) arc_offsets[e + 1] = arc_offsets[e] + g.degree(g.indices[e]);
+        prob2.resize(arc_offsets.back());
+        alias2.resize(arc_offsets.back());
+#pragma omp parallel for schedule(dynamic, 16)
+        for (size_t t = 0; t < g.rows; ++t) {
+            std::vector<double> biased;
+            for (uint64_t e = g.offsets[t]; e < g.offsets[t + 1]; ++e) {
+                uint32_t v = g.indices[e];
+                biased.assign(&weights[g.offsets[v]], &weights[g.offsets[v + 1]]);
+                for (uint64_t f = g.offsets[v]; f < g.offsets[v + 1]; ++f)
+                    biased[f - g.offsets[v]] *= bias(uint32_t(t), g.indices[f]);
+                build_alias(biased.data(), biased.size(), &prob2[arc_offsets[e]], &alias2[arc_offsets[e]]);
+            }
+        }
+    }
+
+    // Next arc out of v, having arrived from t through `arc` (both kNone at
+    // the start of a walk)
+    uint64_t step(uint32_t t, uint32_t v, uint64_t arc, Rng& rng) const {
+        uint64_t b = g.offsets[v];
+        size_t d = g.degree(v);
+        if (arc == kNone || !second_order()) return b + sample_alias(&prob[b], &alias[b], d, rng);
+        if (!arc_offsets.empty())
+            return b + sample_alias(&prob2[arc_offsets[arc]], &alias2[arc_offsets[arc]], d, rng);
+        // Rejection: first-order proposal accepted with bias / max bias
+        double top = std::max({1 / p, 1.0, 1 / q});
+        for (;;) {
+            uint64_t e = b + sample_alias(&prob[b], &alias[b], d, rng);
+            if (rng.uniform() * top < bias(t, g.indices[e])) return e;
+        }
+    }
+};
+
+void write_labels(const std::string& path, const Labels& labels) {
+    std::ofstream out(path);
+    for (const auto& name : labels.names) out << name << '\n';
+    if (!out) throw std::runtime_error(path + ": write failed");
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    try {
+        Args args(argc, argv);
+        Csr g = load_csr(args.get("graph"));
+        if (g.rows != g.cols) throw std::runtime_error("graph must be square");
+        size_t n = g.rows;
+        long walks_arg = args.integer("walks", 100), length_arg = args.integer("length", 80);
+        if (walks_arg < 1) throw std::runtime_error("--walks must be at least 1");
+        if (length_arg < 1) throw std::runtime_error("--length must be at least 1");
+        size_t walks = size_t(walks_arg), length = size_t(length_arg);
+        uint64_t seed = args.integer("seed", 1);
+        std::string out = args.get("out");
+        std::cout << "Graph: " << n << " nodes, " << g.nnz() << " arcs" << std::endl;
+        auto start = std::chrono::steady_clock::now();
+
+        Walker walker{g, {}, args.number("p", 1.0), args.number("q", 1.0), {}, {}, {}, {}, {}};
+        if (!(walker.p > 0 && walker.q > 0)) throw std::runtime_error("--p and --q must be positive");
+        walker.weights.assign(g.values.begin(), g.values.end());
+        if (args.has("unweighted")) std::fill(walker.weights.begin(), walker.weights.end(), 1.0);
+        for (double w : walker.weights)
+            if (w < 0) throw std::runtime_error("negative edge weight; use --unweighted");
+        for (size_t v = 0; v < n; ++v)
+            if (!std::is_sorted(g.indices.data() + g.offsets[v], g.indices.data() + g.offsets[v + 1]))
+                throw std::runtime_error("graph rows must be sorted by column");
+        walker.build_first_order();
+        if (walker.second_order()) {
+            uint64_t entries = 0;
+            for (uint64_t e = 0; e < g.nnz(); ++e) entries += g.degree(g.indices[e]);
+            double mb = entries * (sizeof(float) + sizeof(uint32_t)) / 1048576.0;
+            if (mb <= args.number("max-table-mb", 2048)) {
+                walker.build_second_order();
+                std::cout << "Arc alias tables: " << entries << " entries (" << mb << " MB)" << std::endl;
+            } else {
+                std::cout << "Arc alias tables would take " << mb << " MB; using rejection sampling" << std::endl;
+            }
+        }
+
+        // Blocks of walks are generated independently (one Rng stream per
+        // block, so the corpus does not depend on the thread count) and
+        // written in place with pwrite.
+        std::string path = out + ".walks";
+        int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) throw std::runtime_error(path + ": " + std::strerror(errno));
+        uint64_t total = uint64_t(walks) * n;
+        const uint64_t block = 1024;
+        bool failed = false;
+#pragma omp parallel
+        {
+            std::vector<uint32_t> buffer(block * length);
+#pragma omp for schedule(dynamic, 1)
+            for (uint64_t first = 0; first < total; first += block) {
+                Rng rng(seed, first / block);
+                uint64_t count = std::min(block, total - first);
+                for (uint64_t w = 0; w < count; ++w) {
+                    uint32_t* walk = &buffer[w * length];
+                    uint32_t t = kNone, v = uint32_t((first + w) % n);
+                    uint64_t arc = kNone;
+                    walk[0] = v;
+                    for (size_t s = 1; s < length; ++s) {
+                        if (g.degree(v) == 0) {
+                            std::fill(walk + s, walk + length, kNone);
+                            break;
+                        }
+                        arc = walker.step(t, v, arc, rng);
+                        t = v;
+                        v = g.indices[arc];
+                        walk[s] = v;
+                    }
+                }
+                size_t bytes = count * length * sizeof(uint32_t);
+                if (::pwrite(fd, buffer.data(), bytes, first * length * sizeof(uint32_t)) != ssize_t(bytes)) {
+#pragma omp atomic write
+                    failed = true;
+                }
+            }
+        }
+        if (::close(fd) != 0 || failed) throw std::runtime_error(path + ": write failed");
+        write_labels(out + "_labels.txt", g.row_labels);
+
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << total << " walks of length " << length << " saved to " << path << " in " << seconds << " s"
+                  << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}